@@ -0,0 +1,467 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BenchMaps.hh"
+#include "graph/GridGraph.hh"
+#include "factories/AlgorithmFactory.hh"
+#include "factories/HeuristicFactory.hh"
+#include "utils/Logger.hh"
+
+namespace {
+
+struct Named {
+  const char* name;
+  int value;
+};
+
+const Named kAlgorithms[] = {
+  {"BFS", static_cast<int>(AlgorithmType::BFS)},
+  {"DIJKSTRA", static_cast<int>(AlgorithmType::DIJKSTRA)},
+  {"ASTAR", static_cast<int>(AlgorithmType::ASTAR)},
+  {"IDASTAR", static_cast<int>(AlgorithmType::IDASTAR)},
+  {"DFS", static_cast<int>(AlgorithmType::DFS)},
+  {"JUMPPOINT", static_cast<int>(AlgorithmType::JUMPPOINT)},
+  {"ORTHOGONALJUMPPOINT", static_cast<int>(AlgorithmType::ORTHOGONALJUMPPOINT)},
+  {"TRACE", static_cast<int>(AlgorithmType::TRACE)},
+  {"ARASTAR", static_cast<int>(AlgorithmType::ARASTAR)},
+  {"FOCAL", static_cast<int>(AlgorithmType::FOCAL)},
+  {"THETASTAR", static_cast<int>(AlgorithmType::THETASTAR)},
+  {"LAZYTHETASTAR", static_cast<int>(AlgorithmType::LAZYTHETASTAR)},
+};
+
+const Named kHeuristics[] = {
+  {"MANHATTAN", static_cast<int>(HeuristicType::MANHATTAN)},
+  {"EUCLIDEAN", static_cast<int>(HeuristicType::EUCLIDEAN)},
+  {"OCTILE", static_cast<int>(HeuristicType::OCTILE)},
+  {"CHEBYSHEV", static_cast<int>(HeuristicType::CHEBYSHEV)},
+};
+
+const Named kTieBreaking[] = {
+  {"NONE", static_cast<int>(TieBreaking::NONE)},
+  {"HIGH_G", static_cast<int>(TieBreaking::HIGH_G)},
+  {"CROSS_PRODUCT", static_cast<int>(TieBreaking::CROSS_PRODUCT)},
+  {"LIFO", static_cast<int>(TieBreaking::LIFO)},
+};
+
+struct Movement {
+  const char* name;
+  bool allowDiagonal;
+  bool dontCrossCorners;
+};
+
+const Movement kMovements[] = {
+  {"4", false, false},
+  {"8", true, false},
+  {"8nc", true, true},
+};
+
+struct Options {
+  std::vector<int> sizes{64, 128, 256};
+  std::vector<std::string> families{"open", "random", "maze", "rooms"};
+  std::vector<std::string> algorithms;
+  std::vector<std::string> heuristics;
+  std::vector<std::string> movements;
+  std::vector<std::string> maps;
+  std::vector<std::string> scenarios;
+  std::size_t queries = 16;
+  std::size_t scenarioQueries = 100;
+  uint32_t seed = 42;
+  long budgetMs = 20;
+  std::size_t maxExpansions = 0;
+  double weight = 1.0;
+  std::string tieBreaking = "NONE";
+  bool canonicalOrdering = false;
+  std::string jsonPath;
+  std::string csvPath;
+};
+
+/**
+ * @brief Aggregated measurements for one map x algorithm x heuristic x movement combination.
+ */
+struct Record {
+  std::string map;
+  std::string family;
+  int width = 0;
+  int height = 0;
+  std::string algorithm;
+  std::string heuristic;
+  std::string movement;
+  std::size_t queries = 0;
+  std::size_t solved = 0;
+  std::size_t stopped = 0;
+  std::size_t noPath = 0;
+  std::size_t expansions = 0;
+  std::size_t generated = 0;
+  std::size_t heuristicCalls = 0;
+  std::size_t peakWorkspaceBytes = 0;
+  double expansionsPerSec = 0.0;
+  double meanUs = 0.0;
+  double p50Us = 0.0;
+  double p90Us = 0.0;
+  double p99Us = 0.0;
+  double maxUs = 0.0;
+  double meanCost = 0.0;
+  double meanSuboptimality = 0.0;
+  long rssGrowthKb = -1;
+};
+
+std::vector<std::string> split(const std::string& list) {
+  std::vector<std::string> out;
+  std::istringstream in(list);
+  for (std::string item; std::getline(in, item, ',');) {
+    if (!item.empty()) out.push_back(item);
+  }
+  return out;
+}
+
+bool selected(const std::vector<std::string>& filter, const std::string& name) {
+  return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+}
+
+// Uninformed searches ignore the heuristic, so they run once per movement instead of once per heuristic.
+bool usesHeuristic(AlgorithmType type) {
+  return type != AlgorithmType::BFS && type != AlgorithmType::DIJKSTRA && type != AlgorithmType::DFS &&
+         type != AlgorithmType::TRACE;
+}
+
+// Nearest-rank percentile over sorted samples.
+double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) return 0.0;
+  const std::size_t rank = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+// A "VmRSS:"-style field of /proc/self/status, in KiB; -1 where it cannot be read.
+long procStatusKb(const std::string& field) {
+  std::ifstream in("/proc/self/status");
+  for (std::string line; std::getline(in, line);) {
+    if (line.compare(0, field.size(), field) == 0) return std::atol(line.c_str() + field.size());
+  }
+  return -1;
+}
+
+// Lowers the resident set's high-water mark (VmHWM) to the current resident set (Linux 4.0+), so
+// the next read only covers what ran since. getrusage's ru_maxrss is a lifetime peak and cannot be
+// reset, so once a large configuration ran every later row would repeat its figure.
+bool resetPeakRss() {
+  std::ofstream out("/proc/self/clear_refs");
+  out << "5";
+  out.flush();
+  return static_cast<bool>(out);
+}
+
+std::shared_ptr<GridGraph> buildGraph(const bench::BenchMap& map) {
+  std::vector<Node> nodes;
+  nodes.reserve(map.cells.size());
+  for (int y = 0; y < map.height; ++y) {
+    for (int x = 0; x < map.width; ++x) {
+      const std::size_t idx = static_cast<std::size_t>(y) * static_cast<std::size_t>(map.width) + static_cast<std::size_t>(x);
+      const Cost cost = map.costs.empty() ? 1.0 : static_cast<Cost>(map.costs[idx]);
+      nodes.push_back(Node{static_cast<NodeId>(idx), Point{x, y}, map.cells[idx] == 0, cost});
+    }
+  }
+  return std::make_shared<GridGraph>(map.width, map.height, nodes);
+}
+
+Record runCombo(const bench::BenchMap& map, const std::shared_ptr<GridGraph>& graph, const Named& algorithm,
+                const Named* heuristic, const Movement& movement, const Options& options) {
+  Record rec;
+  rec.map = map.name;
+  rec.family = map.family;
+  rec.width = map.width;
+  rec.height = map.height;
+  rec.algorithm = algorithm.name;
+  rec.heuristic = heuristic ? heuristic->name : "NONE";
+  rec.movement = movement.name;
+
+  const auto type = static_cast<AlgorithmType>(algorithm.value);
+  auto alg = AlgorithmFactory::createAlgorithm(type);
+  if (!alg) return rec;
+
+  AlgorithmConfig base;
+  base.heuristic = HeuristicFactory::createHeuristic(
+      static_cast<HeuristicType>(heuristic ? heuristic->value : static_cast<int>(HeuristicType::MANHATTAN)), graph);
+  base.allowDiagonal = movement.allowDiagonal;
+  base.dontCrossCorners = movement.dontCrossCorners;
+  base.weight = options.weight;
+  base.maxExpansions = options.maxExpansions;
+  base.recording = VisitedRecording::OFF;
+  for (const Named& policy : kTieBreaking) {
+    if (options.tieBreaking == policy.name) base.tieBreaking = static_cast<TieBreaking>(policy.value);
+  }
+  base.canonicalOrdering = options.canonicalOrdering;
+
+  std::vector<double> latencies;
+  latencies.reserve(map.queries.size());
+  double totalUs = 0.0;
+  double costSum = 0.0;
+  double ratioSum = 0.0;
+  std::size_t ratios = 0;
+
+  // Peak resident growth over this configuration's queries, warm-up included. Memory the allocator
+  // kept from earlier rows is reused without showing here; peakWorkspaceBytes is the per-query figure.
+  const long rssBeforeKb = resetPeakRss() ? procStatusKb("VmRSS:") : -1;
+
+  for (std::size_t i = 0; i <= map.queries.size(); ++i) {
+    // The first query runs twice; its first run only warms caches and the allocator.
+    const bench::Query& q = map.queries[i == 0 ? 0 : i - 1];
+    AlgorithmConfig cfg = base;
+    if (options.budgetMs > 0) {
+      cfg.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.budgetMs);
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const Result res = alg->findPath(*graph, q.start, q.goal, cfg);
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    if (i == 0) continue;
+
+    latencies.push_back(us);
+    totalUs += us;
+    rec.expansions += res.stats.expansions;
+    rec.generated += res.stats.generated;
+    rec.heuristicCalls += res.stats.heuristicCalls;
+    rec.peakWorkspaceBytes = std::max<std::size_t>(rec.peakWorkspaceBytes, res.stats.workspaceBytes);
+    if (res.success) {
+      ++rec.solved;
+      costSum += res.cost;
+      if (q.optimal > 0.0) {
+        ratioSum += res.cost / q.optimal;
+        ++ratios;
+      }
+    } else if (res.status == SearchStatus::NO_PATH) {
+      ++rec.noPath;
+    } else {
+      ++rec.stopped;
+    }
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  rec.queries = latencies.size();
+  rec.expansionsPerSec = totalUs > 0.0 ? static_cast<double>(rec.expansions) / (totalUs * 1e-6) : 0.0;
+  rec.meanUs = rec.queries ? totalUs / static_cast<double>(rec.queries) : 0.0;
+  rec.p50Us = percentile(latencies, 0.50);
+  rec.p90Us = percentile(latencies, 0.90);
+  rec.p99Us = percentile(latencies, 0.99);
+  rec.maxUs = latencies.empty() ? 0.0 : latencies.back();
+  rec.meanCost = rec.solved ? costSum / static_cast<double>(rec.solved) : 0.0;
+  rec.meanSuboptimality = ratios ? ratioSum / static_cast<double>(ratios) : 0.0;
+  const long rssPeakKb = rssBeforeKb >= 0 ? procStatusKb("VmHWM:") : -1;
+  rec.rssGrowthKb = rssPeakKb >= 0 ? std::max(0L, rssPeakKb - rssBeforeKb) : -1;
+  return rec;
+}
+
+std::string jsonString(const std::string& s) {
+  std::string out = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+  return out + "\"";
+}
+
+void writeJson(const std::string& path, const std::vector<Record>& records, const Options& options) {
+  std::ofstream out(path);
+  out << "{\n  \"seed\": " << options.seed << ",\n  \"budgetMs\": " << options.budgetMs
+      << ",\n  \"maxExpansions\": " << options.maxExpansions << ",\n  \"weight\": " << options.weight
+      << ",\n  \"tieBreaking\": " << jsonString(options.tieBreaking)
+      << ",\n  \"canonicalOrdering\": " << (options.canonicalOrdering ? "true" : "false")
+      << ",\n  \"results\": [\n";
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    const Record& r = records[i];
+    out << "    {\"map\": " << jsonString(r.map) << ", \"family\": " << jsonString(r.family)
+        << ", \"width\": " << r.width << ", \"height\": " << r.height
+        << ", \"algorithm\": " << jsonString(r.algorithm) << ", \"heuristic\": " << jsonString(r.heuristic)
+        << ", \"movement\": " << jsonString(r.movement) << ", \"queries\": " << r.queries
+        << ", \"solved\": " << r.solved << ", \"stopped\": " << r.stopped << ", \"noPath\": " << r.noPath
+        << ", \"expansions\": " << r.expansions << ", \"generated\": " << r.generated
+        << ", \"heuristicCalls\": " << r.heuristicCalls << ", \"peakWorkspaceBytes\": " << r.peakWorkspaceBytes
+        << ", \"expansionsPerSec\": " << r.expansionsPerSec
+        << ", \"meanUs\": " << r.meanUs << ", \"p50Us\": " << r.p50Us << ", \"p90Us\": " << r.p90Us
+        << ", \"p99Us\": " << r.p99Us << ", \"maxUs\": " << r.maxUs << ", \"meanCost\": " << r.meanCost
+        << ", \"meanSuboptimality\": " << r.meanSuboptimality << ", \"rssGrowthKb\": " << r.rssGrowthKb << "}"
+        << (i + 1 < records.size() ? ",\n" : "\n");
+  }
+  out << "  ]\n}\n";
+}
+
+void writeCsv(const std::string& path, const std::vector<Record>& records) {
+  std::ofstream out(path);
+  out << "map,family,width,height,algorithm,heuristic,movement,queries,solved,stopped,noPath,expansions,"
+         "generated,heuristicCalls,peakWorkspaceBytes,expansionsPerSec,meanUs,p50Us,p90Us,p99Us,maxUs,meanCost,meanSuboptimality,rssGrowthKb\n";
+  for (const Record& r : records) {
+    out << r.map << ',' << r.family << ',' << r.width << ',' << r.height << ',' << r.algorithm << ','
+        << r.heuristic << ',' << r.movement << ',' << r.queries << ',' << r.solved << ',' << r.stopped << ','
+        << r.noPath << ',' << r.expansions << ',' << r.generated << ',' << r.heuristicCalls << ','
+        << r.peakWorkspaceBytes << ',' << r.expansionsPerSec << ',' << r.meanUs << ',' << r.p50Us
+        << ',' << r.p90Us << ',' << r.p99Us << ',' << r.maxUs << ',' << r.meanCost << ','
+        << r.meanSuboptimality << ',' << r.rssGrowthKb << '\n';
+  }
+}
+
+void printUsage(const char* program) {
+  std::cout << "Usage: " << program << " [options]\n"
+            << "  --sizes 64,128,256        synthetic map sizes\n"
+            << "  --families open,random,maze,rooms,terrain\n"
+            << "                            synthetic map families ('none' to skip them)\n"
+            << "  --algorithms ASTAR,...    algorithms to run (default: all)\n"
+            << "  --heuristics OCTILE,...   heuristics to run (default: all)\n"
+            << "  --movements 4,8,8nc       4-connected, 8-connected, 8-connected without corner cutting\n"
+            << "  --queries N               random queries per synthetic or --map map (default 16)\n"
+            << "  --map FILE.map            MovingAI map, queried with random pairs (repeatable)\n"
+            << "  --scen FILE.scen          MovingAI scenario and its map (repeatable)\n"
+            << "  --scen-queries N          scenario entries kept per file, 0 = all (default 100)\n"
+            << "  --seed N                  seed for maps and queries (default 42)\n"
+            << "  --budget-ms N             per-query deadline, 0 = none (default 20)\n"
+            << "  --max-expansions N        per-query expansion limit, 0 = none\n"
+            << "  --weight W                weight for ARA* and Focal (default 1)\n"
+            << "  --tie-breaking P          A* tie-breaking: NONE, HIGH_G, CROSS_PRODUCT, LIFO\n"
+            << "  --canonical 0|1           A* canonical-ordering symmetry reduction\n"
+            << "  --json FILE               write results as JSON\n"
+            << "  --csv FILE                write results as CSV\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") return false;
+    if (i + 1 >= argc) {
+      std::cerr << "missing value for " << arg << "\n";
+      return false;
+    }
+    const std::string value = argv[++i];
+    if (arg == "--sizes") {
+      options.sizes.clear();
+      for (const std::string& s : split(value)) options.sizes.push_back(std::atoi(s.c_str()));
+    } else if (arg == "--families") {
+      options.families = value == "none" ? std::vector<std::string>{} : split(value);
+    } else if (arg == "--algorithms") {
+      options.algorithms = split(value);
+    } else if (arg == "--heuristics") {
+      options.heuristics = split(value);
+    } else if (arg == "--movements") {
+      options.movements = split(value);
+    } else if (arg == "--queries") {
+      options.queries = std::strtoul(value.c_str(), nullptr, 10);
+    } else if (arg == "--map") {
+      options.maps.push_back(value);
+    } else if (arg == "--scen") {
+      options.scenarios.push_back(value);
+    } else if (arg == "--scen-queries") {
+      options.scenarioQueries = std::strtoul(value.c_str(), nullptr, 10);
+    } else if (arg == "--seed") {
+      options.seed = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+    } else if (arg == "--budget-ms") {
+      options.budgetMs = std::atol(value.c_str());
+    } else if (arg == "--max-expansions") {
+      options.maxExpansions = std::strtoul(value.c_str(), nullptr, 10);
+    } else if (arg == "--weight") {
+      options.weight = std::atof(value.c_str());
+    } else if (arg == "--tie-breaking") {
+      options.tieBreaking = value;
+      if (std::none_of(std::begin(kTieBreaking), std::end(kTieBreaking),
+                       [&](const Named& policy) { return value == policy.name; })) {
+        std::cerr << "unknown tie-breaking policy " << value << "\n";
+        return false;
+      }
+    } else if (arg == "--canonical") {
+      options.canonicalOrdering = value != "0";
+    } else if (arg == "--json") {
+      options.jsonPath = value;
+    } else if (arg == "--csv") {
+      options.csvPath = value;
+    } else {
+      std::cerr << "unknown option " << arg << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parseArgs(argc, argv, options)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+  // Every search logs on entry and exit; at benchmark rates that would dominate the timings.
+  utils::Logger::setLevel(utils::LogLevel::ERROR);
+
+  std::vector<bench::BenchMap> maps;
+  for (const std::string& family : options.families) {
+    for (int size : options.sizes) {
+      bench::BenchMap map = bench::makeSyntheticMap(family, size, options.seed);
+      if (map.width == 0) {
+        std::cerr << "unknown map family " << family << "\n";
+        return 1;
+      }
+      bench::addRandomQueries(map, options.queries, options.seed + static_cast<uint32_t>(size));
+      maps.push_back(std::move(map));
+    }
+  }
+  for (const std::string& path : options.maps) {
+    bench::BenchMap map;
+    if (!bench::loadMovingAIMap(path, map)) {
+      std::cerr << "cannot load map " << path << "\n";
+      return 1;
+    }
+    bench::addRandomQueries(map, options.queries, options.seed);
+    maps.push_back(std::move(map));
+  }
+  for (const std::string& path : options.scenarios) {
+    bench::BenchMap map;
+    if (!bench::loadMovingAIScenario(path, options.scenarioQueries, map)) {
+      std::cerr << "cannot load scenario " << path << "\n";
+      return 1;
+    }
+    const NodeId cells = static_cast<NodeId>(map.cells.size());
+    map.queries.erase(std::remove_if(map.queries.begin(), map.queries.end(), [&](const bench::Query& q) {
+      return q.start >= cells || q.goal >= cells;
+    }), map.queries.end());
+    maps.push_back(std::move(map));
+  }
+
+  std::vector<Record> records;
+  std::printf("%-16s %-20s %-10s %-4s %6s %6s %12s %10s %10s %10s %10s %10s\n", "map", "algorithm", "heuristic",
+              "move", "solved", "stop", "exp/s", "p50 us", "p90 us", "p99 us", "ws KiB", "+rss KiB");
+  for (const bench::BenchMap& map : maps) {
+    if (map.queries.empty()) continue;
+    const std::shared_ptr<GridGraph> graph = buildGraph(map);
+    for (const Named& algorithm : kAlgorithms) {
+      if (!selected(options.algorithms, algorithm.name)) continue;
+      const bool informed = usesHeuristic(static_cast<AlgorithmType>(algorithm.value));
+      for (const Movement& movement : kMovements) {
+        if (!selected(options.movements, movement.name)) continue;
+        for (const Named& heuristic : kHeuristics) {
+          if (informed && !selected(options.heuristics, heuristic.name)) continue;
+          const Record rec = runCombo(map, graph, algorithm, informed ? &heuristic : nullptr, movement, options);
+          std::printf("%-16s %-20s %-10s %-4s %6zu %6zu %12.0f %10.1f %10.1f %10.1f %10zu %10ld\n", rec.map.c_str(),
+                      rec.algorithm.c_str(), rec.heuristic.c_str(), rec.movement.c_str(), rec.solved, rec.stopped,
+                      rec.expansionsPerSec, rec.p50Us, rec.p90Us, rec.p99Us, rec.peakWorkspaceBytes / 1024,
+                      rec.rssGrowthKb);
+          std::fflush(stdout);
+          records.push_back(rec);
+          if (!informed) break;
+        }
+      }
+    }
+  }
+
+  if (!options.jsonPath.empty()) writeJson(options.jsonPath, records, options);
+  if (!options.csvPath.empty()) writeCsv(options.csvPath, records);
+  return 0;
+}
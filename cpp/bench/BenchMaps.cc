@@ -0,0 +1,274 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include "BenchMaps.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <utility>
+
+namespace bench {
+
+namespace {
+
+const uint8_t kWall = 1;
+
+std::size_t cellIndex(const BenchMap& map, int x, int y) {
+  return static_cast<std::size_t>(y) * static_cast<std::size_t>(map.width) + static_cast<std::size_t>(x);
+}
+
+void fill(BenchMap& map, uint8_t value) {
+  map.cells.assign(static_cast<std::size_t>(map.width) * static_cast<std::size_t>(map.height), value);
+}
+
+void makeRandom(BenchMap& map, std::mt19937& rng) {
+  std::bernoulli_distribution blocked(0.25);
+  for (uint8_t& c : map.cells) c = blocked(rng) ? kWall : 0;
+}
+
+// Iterative recursive backtracker over the odd coordinates; the even rows and columns are walls
+// that get knocked through as the maze is carved.
+void makeMaze(BenchMap& map, std::mt19937& rng) {
+  fill(map, kWall);
+  const int cols = (map.width - 1) / 2;
+  const int rows = (map.height - 1) / 2;
+  if (cols <= 0 || rows <= 0) return;
+
+  const int dx[4] = {1, -1, 0, 0};
+  const int dy[4] = {0, 0, 1, -1};
+  std::vector<bool> seen(static_cast<std::size_t>(cols) * static_cast<std::size_t>(rows), false);
+  std::vector<std::pair<int, int>> stack{{0, 0}};
+  seen[0] = true;
+  map.cells[cellIndex(map, 1, 1)] = 0;
+
+  while (!stack.empty()) {
+    const auto [cx, cy] = stack.back();
+    int options[4];
+    int count = 0;
+    for (int d = 0; d < 4; ++d) {
+      const int nx = cx + dx[d];
+      const int ny = cy + dy[d];
+      if (nx < 0 || ny < 0 || nx >= cols || ny >= rows) continue;
+      if (!seen[static_cast<std::size_t>(ny) * static_cast<std::size_t>(cols) + static_cast<std::size_t>(nx)]) options[count++] = d;
+    }
+    if (count == 0) {
+      stack.pop_back();
+      continue;
+    }
+    const int d = options[std::uniform_int_distribution<int>(0, count - 1)(rng)];
+    const int nx = cx + dx[d];
+    const int ny = cy + dy[d];
+    seen[static_cast<std::size_t>(ny) * static_cast<std::size_t>(cols) + static_cast<std::size_t>(nx)] = true;
+    map.cells[cellIndex(map, 2 * cx + 1 + dx[d], 2 * cy + 1 + dy[d])] = 0;
+    map.cells[cellIndex(map, 2 * nx + 1, 2 * ny + 1)] = 0;
+    stack.push_back({nx, ny});
+  }
+}
+
+// A lattice of square rooms; every wall segment between two rooms gets a two-cell door.
+void makeRooms(BenchMap& map, std::mt19937& rng) {
+  const int room = std::max(8, map.width / 8);
+  for (int y = 0; y < map.height; ++y) {
+    for (int x = 0; x < map.width; ++x) {
+      if (x % room == room - 1 || y % room == room - 1) map.cells[cellIndex(map, x, y)] = kWall;
+    }
+  }
+  std::uniform_int_distribution<int> offset(0, room - 3);
+  for (int top = 0; top < map.height; top += room) {
+    for (int left = 0; left < map.width; left += room) {
+      const int wallX = left + room - 1;
+      const int wallY = top + room - 1;
+      if (wallX < map.width) {
+        const int door = top + offset(rng);
+        for (int y = door; y < std::min(door + 2, map.height); ++y) map.cells[cellIndex(map, wallX, y)] = 0;
+      }
+      if (wallY < map.height) {
+        const int door = left + offset(rng);
+        for (int x = door; x < std::min(door + 2, map.width); ++x) map.cells[cellIndex(map, x, wallY)] = 0;
+      }
+    }
+  }
+}
+
+// Open ground costing 1 with overlapping square patches of costlier terrain (up to 9), so that
+// shortest paths detour around the expensive areas.
+void makeTerrain(BenchMap& map, std::mt19937& rng) {
+  map.costs.assign(map.cells.size(), 1);
+  const int patches = std::max(1, map.width * map.height / 256);
+  std::uniform_int_distribution<int> coord(0, map.width - 1);
+  std::uniform_int_distribution<int> side(2, std::max(2, map.width / 8));
+  std::uniform_int_distribution<int> cost(2, 9);
+  for (int p = 0; p < patches; ++p) {
+    const int left = coord(rng);
+    const int top = coord(rng) % map.height;
+    const int size = side(rng);
+    const uint8_t c = static_cast<uint8_t>(cost(rng));
+    for (int y = top; y < std::min(top + size, map.height); ++y) {
+      for (int x = left; x < std::min(left + size, map.width); ++x) {
+        uint8_t& cell = map.costs[cellIndex(map, x, y)];
+        cell = std::max(cell, c);
+      }
+    }
+  }
+}
+
+std::string baseName(const std::string& path) {
+  const std::size_t slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+std::string dirName(const std::string& path) {
+  const std::size_t slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? std::string(".") : path.substr(0, slash);
+}
+
+std::string stem(const std::string& path) {
+  std::string name = baseName(path);
+  const std::size_t dot = name.find_last_of('.');
+  return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+} // namespace
+
+BenchMap makeSyntheticMap(const std::string& family, int size, uint32_t seed) {
+  BenchMap map;
+  map.family = family;
+  map.name = family + "-" + std::to_string(size);
+  map.width = size;
+  map.height = size;
+  fill(map, 0);
+
+  std::mt19937 rng(seed);
+  if (family == "open") return map;
+  if (family == "random") makeRandom(map, rng);
+  else if (family == "maze") makeMaze(map, rng);
+  else if (family == "rooms") makeRooms(map, rng);
+  else if (family == "terrain") makeTerrain(map, rng);
+  else map.width = 0;
+  return map;
+}
+
+void addRandomQueries(BenchMap& map, std::size_t count, uint32_t seed) {
+  // Label 4-connected components with a flood fill, then draw from the largest one.
+  const std::size_t n = map.cells.size();
+  std::vector<int> label(n, -1);
+  std::vector<std::size_t> sizes;
+  std::vector<std::size_t> frontier;
+  for (std::size_t s = 0; s < n; ++s) {
+    if (map.cells[s] != 0 || label[s] >= 0) continue;
+    const int id = static_cast<int>(sizes.size());
+    std::size_t size = 0;
+    label[s] = id;
+    frontier.assign(1, s);
+    while (!frontier.empty()) {
+      const std::size_t u = frontier.back();
+      frontier.pop_back();
+      ++size;
+      const int x = static_cast<int>(u % static_cast<std::size_t>(map.width));
+      const int y = static_cast<int>(u / static_cast<std::size_t>(map.width));
+      const int nx[4] = {x + 1, x - 1, x, x};
+      const int ny[4] = {y, y, y + 1, y - 1};
+      for (int d = 0; d < 4; ++d) {
+        if (nx[d] < 0 || ny[d] < 0 || nx[d] >= map.width || ny[d] >= map.height) continue;
+        const std::size_t v = cellIndex(map, nx[d], ny[d]);
+        if (map.cells[v] == 0 && label[v] < 0) {
+          label[v] = id;
+          frontier.push_back(v);
+        }
+      }
+    }
+    sizes.push_back(size);
+  }
+  if (sizes.empty()) return;
+
+  const int largest = static_cast<int>(std::max_element(sizes.begin(), sizes.end()) - sizes.begin());
+  std::vector<NodeId> cells;
+  cells.reserve(sizes[static_cast<std::size_t>(largest)]);
+  for (std::size_t i = 0; i < n; ++i) {
+    if (label[i] == largest) cells.push_back(static_cast<NodeId>(i));
+  }
+  if (cells.size() < 2) return;
+
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<std::size_t> pick(0, cells.size() - 1);
+  for (std::size_t q = 0; q < count; ++q) {
+    Query query;
+    query.start = cells[pick(rng)];
+    do query.goal = cells[pick(rng)]; while (query.goal == query.start);
+    map.queries.push_back(query);
+  }
+}
+
+bool loadMovingAIMap(const std::string& path, BenchMap& map) {
+  std::ifstream in(path);
+  if (!in) return false;
+
+  std::string key;
+  int width = -1;
+  int height = -1;
+  while (in >> key && key != "map") {
+    if (key == "width") in >> width;
+    else if (key == "height") in >> height;
+    else if (key == "type") in >> key;
+    else return false;
+  }
+  if (key != "map" || width <= 0 || height <= 0) return false;
+
+  map.name = stem(path);
+  map.family = "movingai";
+  map.width = width;
+  map.height = height;
+  fill(map, kWall);
+
+  std::string row;
+  for (int y = 0; y < height; ++y) {
+    if (!(in >> row)) return false;
+    for (int x = 0; x < std::min<int>(width, static_cast<int>(row.size())); ++x) {
+      const char c = row[static_cast<std::size_t>(x)];
+      if (c == '.' || c == 'G' || c == 'S') map.cells[cellIndex(map, x, y)] = 0;
+    }
+  }
+  return true;
+}
+
+bool loadMovingAIScenario(const std::string& path, std::size_t maxQueries, BenchMap& map) {
+  std::ifstream in(path);
+  if (!in) return false;
+
+  std::string line;
+  std::string mapFile;
+  std::vector<Query> queries;
+  while (std::getline(in, line)) {
+    if (line.empty() || line.compare(0, 7, "version") == 0) continue;
+    std::istringstream fields(line);
+    int bucket, mapWidth, mapHeight, sx, sy, gx, gy;
+    std::string file;
+    double optimal;
+    if (!(fields >> bucket >> file >> mapWidth >> mapHeight >> sx >> sy >> gx >> gy >> optimal)) return false;
+    if (mapFile.empty()) mapFile = file;
+    Query q;
+    q.start = static_cast<NodeId>(sy * mapWidth + sx);
+    q.goal = static_cast<NodeId>(gy * mapWidth + gx);
+    q.optimal = optimal;
+    queries.push_back(q);
+  }
+  if (mapFile.empty()) return false;
+
+  const std::string dir = dirName(path);
+  if (!loadMovingAIMap(dir + "/" + mapFile, map) && !loadMovingAIMap(dir + "/" + baseName(mapFile), map)) {
+    return false;
+  }
+  map.name = stem(path);
+
+  // Scenario files are sorted by bucket, so a fixed stride keeps easy and hard queries alike.
+  const std::size_t keep = maxQueries == 0 ? queries.size() : std::min(maxQueries, queries.size());
+  map.queries.clear();
+  for (std::size_t i = 0; i < keep; ++i) map.queries.push_back(queries[i * queries.size() / keep]);
+  return true;
+}
+
+} // namespace bench
@@ -0,0 +1,82 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "types/Structs.hh"
+
+namespace bench {
+
+/**
+ * @brief One start/goal pair to benchmark.
+ *
+ * @param start The starting cell index (y * width + x).
+ * @param goal The goal cell index.
+ * @param optimal The reference length from a MovingAI scenario, or 0 when unknown.
+ */
+struct Query {
+  NodeId start;
+  NodeId goal;
+  double optimal = 0.0;
+};
+
+/**
+ * @brief A benchmark map with the queries to run on it.
+ *
+ * Cells follow the engine's convention: 0 = walkable, non-zero = blocked.
+ */
+struct BenchMap {
+  std::string name;
+  std::string family;
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> cells;
+  std::vector<uint8_t> costs;  // Per-cell terrain cost; empty = every cell costs 1
+  std::vector<Query> queries;
+};
+
+/**
+ * @brief Build one of the synthetic map families.
+ *
+ * @param family "open", "random" (about a quarter of the cells blocked), "maze" (a perfect maze
+ * with one-cell corridors), "rooms" (rooms joined by doors) or "terrain" (an open map with patches
+ * of terrain costing 1 to 9).
+ * @param size Width and height of the map.
+ * @param seed Seed for the obstacle layout; the same seed always gives the same map.
+ *
+ * @return The map, without queries. Unknown families return a map with width 0.
+ */
+BenchMap makeSyntheticMap(const std::string& family, int size, uint32_t seed);
+
+/**
+ * @brief Add count random queries whose endpoints are walkable and connected.
+ *
+ * Endpoints are drawn from the same 4-connected component, so every movement mode can solve them.
+ */
+void addRandomQueries(BenchMap& map, std::size_t count, uint32_t seed);
+
+/**
+ * @brief Load a MovingAI .map file ("type octile" header, '.', 'G' and 'S' are passable).
+ *
+ * @return False if the file cannot be read or is malformed.
+ */
+bool loadMovingAIMap(const std::string& path, BenchMap& map);
+
+/**
+ * @brief Load a MovingAI .scen file together with the map it refers to.
+ *
+ * The map path in the scenario is resolved relative to the scenario file, then by file name in the
+ * same directory. When the scenario holds more than maxQueries entries, an evenly spaced subset is
+ * kept so every difficulty bucket stays represented.
+ *
+ * @return False if the scenario or its map cannot be loaded.
+ */
+bool loadMovingAIScenario(const std::string& path, std::size_t maxQueries, BenchMap& map);
+
+} // namespace bench
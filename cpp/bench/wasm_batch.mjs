@@ -0,0 +1,96 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+// Headless run of a WASM build under Node: the same random queries go one by one through
+// PathfindingAPI.findPath and together through PathfindingAPI.findPathBatch. Answers must match;
+// both timings are printed. Exits non-zero on a mismatch.
+//
+// Usage: node bench/wasm_batch.mjs [bin/pathfinding-mt.js] [queries=32] [size=256]
+
+import { createRequire } from "node:module";
+import path from "node:path";
+import { performance } from "node:perf_hooks";
+
+const require = createRequire(import.meta.url);
+const [modulePath = "bin/pathfinding-mt.js", queryArg = "32", sizeArg = "256"] = process.argv.slice(2);
+const queryCount = Number(queryArg);
+const size = Number(sizeArg);
+
+const factory = require(path.resolve(modulePath));
+if (typeof factory !== "function") {
+	// Inside an ESM package scope the UMD bundle is loaded as a module and exports nothing.
+	console.error(`${modulePath} did not load as CommonJS; put {"type": "commonjs"} in a package.json next to it`);
+	process.exit(2);
+}
+const Module = await factory({ print: () => {} });
+const api = Module.PathfindingAPI;
+if (typeof api.findPathBatch !== "function") {
+	console.error(`${modulePath} has no PathfindingAPI.findPathBatch`);
+	process.exit(2);
+}
+
+// Small LCG so every run searches the same maps.
+let seed = 12345;
+const random = () => {
+	seed = (Math.imul(seed, 1103515245) + 12345) >>> 0;
+	return seed / 2 ** 32;
+};
+
+const config = {
+	algorithm: Module.AlgorithmType.ASTAR,
+	heuristic: Module.HeuristicType.OCTILE,
+	allowDiagonal: true,
+	dontCrossCorners: false,
+	bidirectional: false,
+	recording: Module.VisitedRecording.OFF,
+	recordingSampleRate: 1,
+	weight: 1,
+	timeBudgetUs: 0,
+	maxExpansions: 0,
+	tieBreaking: Module.TieBreaking.NONE,
+	canonicalOrdering: false,
+	precision: Module.CostPrecision.DOUBLE,
+	smoothing: Module.PathSmoothing.NONE,
+	chainCode: false,
+	keepCellPath: true,
+	mapVersion: 0,
+};
+
+const queries = [];
+for (let q = 0; q < queryCount; q++) {
+	const grid = new Uint8Array(size * size);
+	for (let i = 0; i < grid.length; i++) grid[i] = random() < 0.25 ? 1 : 0;
+	const startIndex = Math.floor(random() * grid.length);
+	const goalIndex = Math.floor(random() * grid.length);
+	grid[startIndex] = 0;
+	grid[goalIndex] = 0;
+	queries.push({ grid, width: size, height: size, startIndex, goalIndex, config });
+}
+
+let t0 = performance.now();
+const single = queries.map((q) => {
+	const r = api.findPath(q.grid, q.width, q.height, q.startIndex, q.goalIndex, q.config);
+	return { success: r.success, cost: r.cost };
+});
+const sequentialMs = performance.now() - t0;
+
+t0 = performance.now();
+const batch = api.findPathBatch(queries, 0);
+const batchMs = performance.now() - t0;
+
+let mismatches = 0;
+for (let i = 0; i < queries.length; i++) {
+	if (batch[i].success !== single[i].success || Math.abs(batch[i].cost - single[i].cost) > 1e-9) {
+		console.error(`query ${i}: batch ${batch[i].success}/${batch[i].cost} vs ${single[i].success}/${single[i].cost}`);
+		mismatches++;
+	}
+}
+
+const solved = single.filter((r) => r.success).length;
+console.log(
+	`${queryCount} queries on ${size}x${size} (${solved} solvable): one by one ${sequentialMs.toFixed(1)} ms, ` +
+		`batch ${batchMs.toFixed(1)} ms (x${(sequentialMs / batchMs).toFixed(2)})`,
+);
+process.exit(mismatches === 0 ? 0 : 1);
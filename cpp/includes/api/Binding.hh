@@ -5,8 +5,16 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
+
 #include <emscripten/val.h>
 #include "types/Enums.hh"
+#include "types/Structs.hh"
+#include "api/IncrementalPlanner.hh"
+#include "api/PathDatabase.hh"
+#include "api/ResumableQuery.hh"
+#include "api/RouteCache.hh"
 
 namespace api {
 
@@ -16,10 +24,40 @@ struct PathfindingConfig {
   bool allowDiagonal = true;
   bool dontCrossCorners = false;
   bool bidirectional = false;
+  VisitedRecording recording = VisitedRecording::FULL;
+  uint32_t recordingSampleRate = 16;
+  double weight = 1.0;
+  double timeBudgetUs = 0.0;
+  uint32_t maxExpansions = 0;
+  TieBreaking tieBreaking = TieBreaking::NONE;
+  bool canonicalOrdering = false;
+  CostPrecision precision = CostPrecision::DOUBLE;
+  PathSmoothing smoothing = PathSmoothing::NONE;
+  bool chainCode = false;
+  bool keepCellPath = true;
+  double mapVersion = 0.0;  // > 0: the grid's contents under this version; see PathfindingAPI::findPath
 };
 
 class PathfindingAPI {
 public:
+  /**
+   * Returns a Uint8Array of `size` cells backed by module memory. Grids written into it are
+   * searched in place by findPath. The view is invalidated by the next gridBuffer() call and by
+   * memory growth, so fetch it again rather than caching it.
+   */
+  static emscripten::val gridBuffer(int size);
+
+  /**
+   * Runs a search on `gridArray` (row-major, 0 = walkable). A Uint8Array obtained from
+   * gridBuffer() is read in place; any other array is copied into module memory in one bulk
+   * TypedArray.set. `path` and `visited` in the returned object are Uint32Array views over the
+   * module-owned result and stay valid until the next findPath call: copy them (slice/Array.from)
+   * to keep them longer.
+   *
+   * With `config.mapVersion` > 0 the grid's component labels are kept under that version, so a
+   * goal walled off from the start is answered NO_PATH without a search. Use a new version
+   * whenever the grid or costs change. With 0 nothing is kept and such a goal costs a full search.
+   */
   static emscripten::val findPath(
       const emscripten::val& gridArray,
       int width,
@@ -28,6 +66,180 @@ public:
       int goalIndex,
       const PathfindingConfig& config
   );
+
+  /**
+   * findPath on weighted terrain. `costArray` holds one cost per cell: a Uint8Array is read as
+   * bytes, any other array (typically a Float32Array) as floats. Entering a cell costs its value
+   * and a diagonal move sqrt(2) times that; a cost of 0 blocks the cell like a wall does.
+   */
+  static emscripten::val findPathWeighted(
+      const emscripten::val& gridArray,
+      const emscripten::val& costArray,
+      int width,
+      int height,
+      int startIndex,
+      int goalIndex,
+      const PathfindingConfig& config
+  );
+
+  /**
+   * findPath that hands the expanded nodes to `onVisited` while the search runs instead of
+   * returning them: it is called with a Uint32Array of up to `chunkSize` NodeIds at a time (0 =
+   * 1024), in expansion order, and the result's `visited` is empty. Each array is a view over a
+   * module buffer reused for the next chunk, so copy it to keep it; memory stays at one chunk
+   * however many nodes the search expands. `config.recording` is ignored.
+   */
+  static emscripten::val findPathStreaming(
+      const emscripten::val& gridArray,
+      int width,
+      int height,
+      int startIndex,
+      int goalIndex,
+      const PathfindingConfig& config,
+      const emscripten::val& onVisited,
+      int chunkSize
+  );
+
+  /**
+   * Runs independent searches concurrently. `queries` is an array of
+   * `{ grid, width, height, startIndex, goalIndex, config }`; every grid is copied in first, then
+   * the searches share up to `maxThreads` threads (0 = one per core). Returns one result object
+   * per query, in order, with arrays valid until the next findPathBatch call. In a build without
+   * pthreads the queries simply run one after another.
+   */
+  static emscripten::val findPathBatch(const emscripten::val& queries, int maxThreads);
+
+  /**
+   * Hop counts from every cell of `sources` (an array of cell indices) at once, up to 256
+   * breadth-first searches per sweep of the grid. With a non-empty `targets` array the result is
+   * the sources x targets matrix, row per source; with an empty one, each source's distance field
+   * over the whole grid (width * height entries per source). Unreachable entries are 0xFFFFFFFF.
+   * Only `config.allowDiagonal` and `config.dontCrossCorners` are read. The Uint32Array is a view
+   * valid until the next hopDistances call.
+   */
+  static emscripten::val hopDistances(
+      const emscripten::val& gridArray,
+      int width,
+      int height,
+      const emscripten::val& sources,
+      const emscripten::val& targets,
+      const PathfindingConfig& config
+  );
+
+  /**
+   * Shortest-path costs from every cell of `sources` to every cell of `targets`, as a Float64Array
+   * of sources.length * targets.length entries, row per source; unreachable pairs are Infinity.
+   * One Dijkstra per source, spread over up to `maxThreads` threads (0 = the whole pool), each
+   * stopped once the targets it can reach are settled. Honours `config.allowDiagonal`. The array
+   * is a view valid until the next costMatrix call.
+   */
+  static emscripten::val costMatrix(
+      const emscripten::val& gridArray,
+      int width,
+      int height,
+      const emscripten::val& sources,
+      const emscripten::val& targets,
+      const PathfindingConfig& config,
+      int maxThreads
+  );
+};
+
+/**
+ * Stateful D* Lite planner for JS (exported as `IncrementalPlanner`). Edit cells with setCell()
+ * and call replan(); only the part of the search affected by the edits is redone. Arrays in the
+ * object returned by replan() are views valid until the next replan() on the same planner. Call
+ * delete() when done.
+ */
+class PlannerAPI {
+public:
+  PlannerAPI(
+      const emscripten::val& gridArray,
+      int width,
+      int height,
+      int startIndex,
+      int goalIndex,
+      const PathfindingConfig& config
+  );
+
+  void setStart(int index);
+  void setGoal(int index);
+  void setCell(int index, bool blocked);
+  emscripten::val replan();
+
+private:
+  std::unique_ptr<IncrementalPlanner> planner_;
+  Result lastResult_;
+};
+
+/**
+ * Time-sliced A* / Dijkstra query for JS (exported as `ResumableQuery`). Call step(budgetUs) once
+ * per frame until it returns true, then read result(); its arrays are views valid until the query
+ * is deleted. Call delete() when done.
+ */
+class QueryAPI {
+public:
+  QueryAPI(
+      const emscripten::val& gridArray,
+      int width,
+      int height,
+      int startIndex,
+      int goalIndex,
+      const PathfindingConfig& config
+  );
+
+  bool step(double budgetUs);
+  bool done() const;
+  emscripten::val result() const;
+
+private:
+  std::unique_ptr<ResumableQuery> query_;
+};
+
+/**
+ * Compressed path database for JS (exported as `PathDatabase`). The constructor precomputes the
+ * first moves between every pair of cells of a fixed grid (config.allowDiagonal is used, the rest
+ * is ignored); findPath() then answers without searching. Arrays in the returned object are views
+ * valid until the next findPath() on the same database. Call delete() when done.
+ */
+class DatabaseAPI {
+public:
+  DatabaseAPI(const emscripten::val& gridArray, int width, int height, const PathfindingConfig& config);
+
+  emscripten::val findPath(int startIndex, int goalIndex);
+  int runCount() const;
+
+private:
+  std::unique_ptr<PathDatabase> database_;
+  Result lastResult_;
+};
+
+/**
+ * Route cache for JS (exported as `RouteCache`). findPath() behaves like PathfindingAPI.findPath
+ * with an extra map version; bump the version or call invalidateCell() when the grid changes.
+ * Arrays in the returned object are views valid until the next findPath() on the same cache.
+ */
+class CacheAPI {
+public:
+  explicit CacheAPI(int capacity);
+
+  emscripten::val findPath(
+      const emscripten::val& gridArray,
+      int width,
+      int height,
+      int startIndex,
+      int goalIndex,
+      const PathfindingConfig& config,
+      double mapVersion
+  );
+
+  void invalidate(double mapVersion);
+  void invalidateCell(double mapVersion, int cell, bool blocked);
+  void clear();
+  int size() const;
+
+private:
+  RouteCache cache_;
+  Result lastResult_;
 };
 
 } // namespace api
\ No newline at end of file
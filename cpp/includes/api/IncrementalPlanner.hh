@@ -0,0 +1,61 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "api/PathfindingEngine.hh"
+#include "graph/GridGraph.hh"
+#include "algorithms/DStarLite.hh"
+#include "types/Structs.hh"
+
+/**
+ * @brief Stateful planner for grids that change between queries.
+ *
+ * Where PathfindingEngine::findPath rebuilds the graph and searches from scratch on every call, an
+ * IncrementalPlanner keeps its grid and a D* Lite search alive. After setCell() or setStart(), the
+ * next replan() only repairs the part of the search affected by the edit.
+ *
+ * @public Is exposed to JavaScript through the WebAssembly bindings.
+ */
+class IncrementalPlanner {
+
+  private:
+    std::shared_ptr<GridGraph> graph_;
+    std::unique_ptr<DStarLite> planner_;
+    NodeCount nodeCount_;
+
+  public:
+    /**
+     * @brief Build the planner from a row-major grid (0 = walkable, non-zero = blocked).
+     *
+     * @param options Movement flags, heuristic and terrain; options.algorithm is ignored (always
+     * D* Lite).
+     */
+    IncrementalPlanner(
+        const uint8_t* grid,
+        std::size_t gridSize,
+        int width,
+        int height,
+        int startIndex,
+        int goalIndex,
+        const EngineOptions& options);
+
+    void setStart(int index);
+    void setGoal(int index);
+
+    /**
+     * @brief Add (blocked = true) or remove a wall.
+     */
+    void setCell(int index, bool blocked);
+
+    /**
+     * @brief Bring the path up to date with every change since the previous call.
+     */
+    Result replan();
+};
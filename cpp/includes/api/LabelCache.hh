@@ -0,0 +1,72 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include "api/PathfindingEngine.hh"
+#include "graph/ComponentLabels.hh"
+
+/**
+ * @brief Component labels of the grids a caller searches repeatedly, keyed by a caller-chosen map
+ * version.
+ *
+ * PathfindingEngine::findPath keeps nothing between calls, so it only skips a walled-off goal when
+ * EngineOptions::components is set. This keeps those labels: the first query of a version labels
+ * its grid, and later queries of that version reuse the labels. RouteCache keeps one, and so do
+ * the JS bindings for queries that pass a mapVersion.
+ *
+ * Thread-safe. Labelling runs unlocked, so concurrent first queries of a version may both label;
+ * the first result stored is kept.
+ */
+class LabelCache {
+
+  private:
+    struct Entry {
+      uint64_t mapVersion;
+      int width;
+      int height;
+      std::shared_ptr<const ComponentLabels> labels;
+    };
+
+    mutable std::mutex mutex_;
+    std::list<Entry> entries_;  // most recently used first
+
+  public:
+    // Map versions kept; older ones are labelled again if searched again.
+    static constexpr std::size_t kVersions = 4;
+
+    /**
+     * @brief Label a grid as the engine's graph sees it: a cell is walkable when it is 0 in the grid
+     * and the terrain does not block it. Cells past gridSize are blocked.
+     */
+    static std::shared_ptr<const ComponentLabels> label(
+        const uint8_t* grid, std::size_t gridSize, int width, int height, const TerrainCosts& terrain);
+
+    /**
+     * @brief The labels of mapVersion, labelling the grid if the version is not kept yet.
+     *
+     * The grid and terrain must hold the same contents every time a version is passed, and a new
+     * version must be used whenever either changes. A version seen with other dimensions is labelled
+     * again.
+     *
+     * @return The labels, valid for as long as the caller holds them; nullptr for an empty grid.
+     */
+    std::shared_ptr<const ComponentLabels> labelsFor(
+        const uint8_t* grid, std::size_t gridSize, int width, int height, const TerrainCosts& terrain,
+        uint64_t mapVersion);
+
+    /**
+     * @brief Forget the labels of a map version (e.g. after a wall edit split a component).
+     */
+    void drop(uint64_t mapVersion);
+
+    void clear();
+};
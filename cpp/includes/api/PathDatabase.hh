@@ -0,0 +1,96 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/PathfindingEngine.hh"
+#include "graph/GridGraph.hh"
+#include "types/Structs.hh"
+
+/**
+ * @brief Compressed path database (first-move table) for a fixed grid.
+ *
+ * Built once: a Dijkstra from every walkable cell records, for every other cell, the first moves
+ * of shortest paths to it. Each source's row lists a move per target cell, with targets in Morton
+ * order, run-length compressed: a run is the first target it covers plus a chain code (see
+ * ChainCode). Where several moves are optimal, or none is needed (walls, unreachable targets, the
+ * source itself), the one that extends the current run is taken. A query then walks from start to
+ * goal one looked-up move at a time, with no search: O(path length * log(runs in a row)).
+ *
+ * Paths are Dijkstra's: terrain costs and allowDiagonal are honoured, dontCrossCorners is not.
+ * The database can be saved to disk and loaded back without rebuilding.
+ *
+ * @public Is exposed to JavaScript through the WebAssembly bindings.
+ */
+class PathDatabase {
+
+  private:
+    int width_;
+    int height_;
+    bool allowDiagonal_;
+    std::vector<Cost> costs_;            // cost of entering each cell, 0 = blocked
+    std::shared_ptr<GridGraph> graph_;   // rebuilt from costs_, with component labels
+    std::vector<uint32_t> rank_;         // position of each cell in Morton order, recomputed on load
+    std::vector<uint64_t> rowOffsets_;   // runs of source s are runs_[rowOffsets_[s], rowOffsets_[s + 1])
+    std::vector<uint32_t> runs_;         // (rank of first target << 3) | chain code
+
+    // Everything derived from width_, height_ and costs_.
+    void prepare();
+
+  public:
+    /**
+     * @brief Build the database of a row-major grid (0 = walkable, non-zero = blocked).
+     *
+     * @param options options.terrain and options.allowDiagonal are used, the rest is ignored.
+     * @param maxThreads Upper bound on the threads used, the caller included (0 = one per core).
+     * @throws std::invalid_argument if the grid is empty or has more than 2^29 cells.
+     */
+    PathDatabase(
+        const uint8_t* grid,
+        std::size_t gridSize,
+        int width,
+        int height,
+        const EngineOptions& options,
+        unsigned maxThreads = 0);
+
+    /**
+     * @brief Load a database written by save().
+     * @throws std::runtime_error if the file cannot be read or is not a path database.
+     */
+    explicit PathDatabase(const std::string& path);
+
+    /**
+     * @brief Write the database to path.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Shortest path from start to goal, by following first moves.
+     *
+     * INVALID_INPUT for out-of-range or blocked starts and out-of-range goals, NO_PATH when the
+     * goal cannot be reached. stats.expansions stays 0.
+     */
+    Result findPath(int startIndex, int goalIndex) const;
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    /**
+     * @brief Runs stored over all rows.
+     */
+    std::size_t runCount() const { return runs_.size(); }
+
+    /**
+     * @brief Bytes held by the first-move table.
+     */
+    std::size_t bytes() const { return runs_.size() * sizeof(uint32_t) + rowOffsets_.size() * sizeof(uint64_t); }
+};
@@ -5,10 +5,96 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <vector>
 
 #include "types/Structs.hh"
 #include "types/Enums.hh"
+#include "algorithms/CancellationToken.hh"
+
+class ComponentLabels;
+class GridGraph;
+struct AlgorithmConfig;
+
+/**
+ * @brief Read-only view of a per-cell terrain cost layer owned by the caller.
+ *
+ * Set either bytes or values (row-major, like the grid). Entering a cell costs its value, and a
+ * diagonal move sqrt(2) times that. A value of 0 (or, for floats, anything that is not a positive
+ * finite number) blocks the cell; cells past size cost 1. An empty layer is a unit-cost grid.
+ */
+struct TerrainCosts {
+  const uint8_t* bytes = nullptr;
+  const float* values = nullptr;
+  std::size_t size = 0;
+
+  bool empty() const { return bytes == nullptr && values == nullptr; }
+
+  /**
+   * @brief Cost of entering cell i, or 0 when the layer blocks it.
+   */
+  Cost at(std::size_t i) const {
+    if (i >= size) return 1.0;
+    if (bytes) return static_cast<Cost>(bytes[i]);
+    const Cost v = static_cast<Cost>(values[i]);
+    return (v > 0.0 && v <= std::numeric_limits<Cost>::max()) ? v : 0.0;
+  }
+};
+
+/**
+ * @brief Per-query options for PathfindingEngine::findPath.
+ *
+ * Mirrors the flags of the positional overload and carries the options added since, so new
+ * knobs do not keep growing the argument list.
+ */
+struct EngineOptions {
+  AlgorithmType algorithm = AlgorithmType::ASTAR;
+  HeuristicType heuristic = HeuristicType::MANHATTAN;
+  bool allowDiagonal = true;
+  bool dontCrossCorners = false;
+  bool bidirectional = false;
+  VisitedRecording recording = VisitedRecording::FULL;
+  uint32_t recordingSampleRate = 16;
+  VisitSink onVisited = nullptr;       // Receives the expansions with VisitedRecording::STREAM
+  std::size_t visitChunkSize = 1024;   // NodeIds per onVisited call
+  Cost weight = 1.0;
+  Time timeBudget = Time::zero();  // Query deadline; ARA* improves its path until then (0 = no limit)
+  std::size_t maxExpansions = 0;   // Stop after this many expansions (0 = no limit)
+  std::shared_ptr<const CancellationToken> cancel = nullptr;
+  TieBreaking tieBreaking = TieBreaking::NONE;  // A* only: order among equal-f nodes
+  bool canonicalOrdering = false;               // A* only: canonical-ordering symmetry reduction
+  CostPrecision precision = CostPrecision::DOUBLE;  // A* and Dijkstra: score type (FLOAT / FIXED halve it)
+  TerrainCosts terrain;                         // Per-cell costs; empty = every cell costs 1
+  PathSmoothing smoothing = PathSmoothing::NONE;  // Post-processing into Result::waypoints
+  bool chainCode = false;                       // Also return the path as Result::chainCode
+  bool keepCellPath = true;                     // False drops Result::path once waypoints or the chain code are set
+  // Where the Result's arrays (path, visited, waypoints, ...) are allocated; must outlive the Result
+  // and, in a batch, be safe to use from every worker (e.g. a std::pmr::synchronized_pool_resource).
+  std::pmr::memory_resource* resultMemory = std::pmr::get_default_resource();
+  // Component labels of this exact grid and terrain, kept by the caller across queries (e.g. from a
+  // LabelCache, per map version). When set, a goal in another component is answered NO_PATH
+  // without a search; nullptr skips that check rather than labelling the grid per query.
+  const ComponentLabels* components = nullptr;
+};
+
+/**
+ * @brief One query of a batch: a grid owned by the caller and the search to run on it.
+ *
+ * Queries of a batch may share a grid; it is only read.
+ */
+struct PathQuery {
+  const uint8_t* grid = nullptr;
+  std::size_t gridSize = 0;
+  int width = 0;
+  int height = 0;
+  int startIndex = -1;
+  int goalIndex = -1;
+  EngineOptions options;
+};
 
 /**
  * @brief Pathfinding engine providing a unified interface for various algorithms.
@@ -21,6 +107,44 @@
 class PathfindingEngine {
 
   public:
+    /**
+     * @brief The graph findPath searches: a row-major grid (0 = walkable, non-zero = blocked) with
+     * an optional terrain layer, its arrays allocated from memory. Cells past gridSize are blocked.
+     *
+     * Shared with the stateful front ends (ResumableQuery, IncrementalPlanner) that keep a graph
+     * across calls.
+     */
+    static std::shared_ptr<GridGraph> buildGraph(
+        const uint8_t* grid,
+        std::size_t gridSize,
+        int width,
+        int height,
+        const TerrainCosts& terrain = TerrainCosts{},
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * @brief Whether findPath answers NO_PATH without searching: the goal is blocked, or
+     * options.components puts it in another component than the start. Logs when it does.
+     *
+     * Shared with the stateful front ends, like buildGraph, so they skip the same searches.
+     */
+    static bool unreachable(const GridGraph& graph, int startIndex, int goalIndex, const EngineOptions& options);
+
+    /**
+     * @brief The AlgorithmConfig findPath hands the algorithm for options, with its heuristic built
+     * on graph and every per-search array allocated from memory.
+     */
+    static AlgorithmConfig algorithmConfig(
+        const EngineOptions& options,
+        const std::shared_ptr<GridGraph>& graph,
+        std::pmr::memory_resource* memory);
+
+    /**
+     * @brief What findPath does to a finished search: options.chainCode, options.smoothing and
+     * options.keepCellPath.
+     */
+    static void postProcess(const GridGraph& graph, const EngineOptions& options, Result& res);
+
     static Result findPath(
         const std::vector<int>& grid,
         int width,
@@ -32,4 +156,84 @@ class PathfindingEngine {
         bool allowDiagonal = true,
         bool dontCrossCorners = false,
         bool bidirectional = false);
-};
\ No newline at end of file
+
+    /**
+     * @brief Same as above, reading the grid from a byte buffer owned by the caller.
+     *
+     * Used by the WASM bindings to search a grid that already lives in module memory without
+     * copying it into a std::vector first. Cells past gridSize are treated as blocked.
+     *
+     * findPath keeps nothing between calls, so a goal walled off from the start is only rejected
+     * without a search when options.components holds the grid's labels. Without them the search
+     * explores the start's whole component before it answers NO_PATH. Callers that search a grid
+     * repeatedly keep labels in a LabelCache, or go through RouteCache, which does that for them.
+     */
+    static Result findPath(
+        const uint8_t* grid,
+        std::size_t gridSize,
+        int width,
+        int height,
+        int startIndex,
+        int goalIndex,
+        const EngineOptions& options);
+
+    /**
+     * @brief Run independent queries concurrently, one search per worker thread at a time.
+     *
+     * Workers pull the next query as they finish, so long and short searches balance out. The
+     * calling thread works too; where no thread can be started (a WASM build without pthreads)
+     * every query runs on it in turn.
+     *
+     * Queries without options.components that share a grid (same pointer, size and terrain) have
+     * it labelled once for the batch, so their walled-off goals are answered without a search.
+     *
+     * @param maxThreads Upper bound on the threads used, the caller included (0 = one per core).
+     * @return One Result per query, in query order.
+     */
+    static std::vector<Result> findPaths(const std::vector<PathQuery>& queries, unsigned maxThreads = 0);
+
+    /**
+     * @brief Hop counts from many cells at once, on the grid findPath would search.
+     *
+     * Runs MultiSourceBFS: up to 256 breadth-first searches share each sweep of the grid. Moves
+     * follow options.allowDiagonal and options.dontCrossCorners, terrain cells of cost 0 are
+     * blocked, and every move is one hop; the other options are ignored.
+     *
+     * @param targets Cells to measure to; empty returns whole distance fields instead.
+     * @return With targets, entry s * targets.size() + t is the hop count from sources[s] to
+     * targets[t]; without, entry s * width * height + cell. Unreachable pairs, and blocked or
+     * out-of-range sources and targets, read MultiSourceBFS::kUnreachable (0xFFFFFFFF).
+     */
+    static std::vector<uint32_t> hopDistances(
+        const uint8_t* grid,
+        std::size_t gridSize,
+        int width,
+        int height,
+        const std::vector<int>& sources,
+        const std::vector<int>& targets,
+        const EngineOptions& options);
+
+    /**
+     * @brief Shortest-path costs between every source and every target, on the grid findPath
+     * would search.
+     *
+     * Runs DistanceMatrix: one Dijkstra per source, spread over up to maxThreads threads (0 = one
+     * per core) and stopped once its reachable targets are settled. The grid's component labels
+     * (options.components, or labelled once for the call) tell it which targets those are, so an
+     * unreachable target costs nothing to wait for. Costs
+     * follow options.terrain and options.allowDiagonal, as with AlgorithmType::DIJKSTRA; the
+     * other options are ignored.
+     *
+     * @return Entry s * targets.size() + t is the cost from sources[s] to targets[t]; unreachable
+     * pairs, and blocked or out-of-range cells, are infinity.
+     */
+    static std::vector<Cost> costMatrix(
+        const uint8_t* grid,
+        std::size_t gridSize,
+        int width,
+        int height,
+        const std::vector<int>& sources,
+        const std::vector<int>& targets,
+        const EngineOptions& options,
+        unsigned maxThreads = 0);
+};
@@ -0,0 +1,72 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+#include "api/PathfindingEngine.hh"
+#include "graph/GridGraph.hh"
+#include "algorithms/AStarSearch.hh"
+#include "types/Structs.hh"
+
+/**
+ * @brief A grid query that is searched a slice at a time.
+ *
+ * For callers with a per-frame budget (e.g. a game loop): build the query once, call step() every
+ * frame until it returns true, then read result(). The grid is copied, so the caller's buffer may
+ * change while the query is in flight.
+ *
+ * The search is AStar's own (AStarSearch), configured as findPath configures it, so the options
+ * findPath honours for ASTAR and DIJKSTRA apply here too, and findPath's post-processing (chain
+ * code, smoothing, keepCellPath) runs once the search is done.
+ *
+ * @public Is exposed to JavaScript through the WebAssembly bindings.
+ */
+class ResumableQuery {
+
+  private:
+    EngineOptions options_;
+    // The query's own arena for the graph and search arrays: a thread's QueryArena scope cannot
+    // stay open across frames. Declared first so it outlives both.
+    std::pmr::monotonic_buffer_resource memory_;
+    std::shared_ptr<GridGraph> graph_;
+    std::unique_ptr<AStarSearch> search_;
+    Result result_;
+    bool done_ = false;
+
+    void finish(Result res);
+
+  public:
+    /**
+     * @brief Build the query from a row-major grid (0 = walkable, non-zero = blocked).
+     *
+     * @param options options.algorithm must be ASTAR or DIJKSTRA; any other leaves the query done
+     * with success = false. timeBudget and maxExpansions bound the whole query, not a single
+     * slice. A blocked goal, or one options.components puts out of reach, is answered NO_PATH
+     * without a search. tieBreaking and canonicalOrdering are A* only, as in findPath.
+     */
+    ResumableQuery(
+        const uint8_t* grid,
+        std::size_t gridSize,
+        int width,
+        int height,
+        int startIndex,
+        int goalIndex,
+        const EngineOptions& options);
+
+    /**
+     * @brief Run one slice of at most budget.
+     *
+     * @return True once the search is done.
+     */
+    bool step(Time budget);
+
+    bool done() const;
+    const Result& result() const;
+};
@@ -0,0 +1,160 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "api/PathfindingEngine.hh"
+#include "api/LabelCache.hh"
+#include "types/Structs.hh"
+#include "types/Enums.hh"
+
+/**
+ * @brief Thread-safe LRU cache of routes in front of PathfindingEngine.
+ *
+ * Entries are keyed by a caller-chosen map version plus start, goal and the options that change
+ * the answer (algorithm, heuristic, movement flags, weight, A* ordering options, smoothing).
+ * Besides exact hits, a query whose start and goal both lie, in order, on a cached optimal path
+ * under the same key is answered with that slice of the path: every subpath of a shortest path is
+ * itself a shortest path.
+ *
+ * The cache also labels the connected components of each map version once, on its first miss,
+ * and hands the labels to every search of that version, so a miss whose goal is walled off from
+ * its start is answered NO_PATH without a search.
+ *
+ * The lock is only held for lookups and inserts; searches on a miss run unlocked, so concurrent
+ * misses on the same route may both search.
+ *
+ * @public Is exposed to JavaScript through the WebAssembly bindings.
+ */
+class RouteCache {
+
+  private:
+    // Everything in the key except the endpoints. Subpaths are only shared within one of these.
+    struct ConfigKey {
+      uint64_t mapVersion;
+      AlgorithmType algorithm;
+      HeuristicType heuristic;
+      bool allowDiagonal;
+      bool dontCrossCorners;
+      bool bidirectional;
+      Cost weight;
+      TieBreaking tieBreaking;
+      bool canonicalOrdering;
+      CostPrecision precision;
+      PathSmoothing smoothing;
+      bool chainCode;
+      bool keepCellPath;
+      bool operator==(const ConfigKey& o) const;
+    };
+
+    struct RouteKey {
+      ConfigKey config;
+      NodeId start;
+      NodeId goal;
+      bool operator==(const RouteKey& o) const;
+    };
+
+    struct NodeKey {
+      ConfigKey config;
+      NodeId node;
+      bool operator==(const NodeKey& o) const;
+    };
+
+    struct KeyHash {
+      std::size_t operator()(const ConfigKey& k) const;
+      std::size_t operator()(const RouteKey& k) const;
+      std::size_t operator()(const NodeKey& k) const;
+    };
+
+    struct Entry {
+      RouteKey key;
+      Result result;              // path, waypoints, chain code, cost, success, status and bound; visited is dropped
+      std::vector<Cost> prefix;   // prefix[i] = cost of path[0..i]; empty if not indexed for subpaths
+      int width;                  // grid width, to walk the route's segments and chain code
+    };
+
+    using EntryList = std::list<Entry>;
+
+    struct Occurrence {
+      EntryList::iterator entry;
+      std::size_t position;
+    };
+
+    std::size_t capacity_;
+    mutable std::mutex mutex_;
+    EntryList entries_;  // most recently used first
+    std::unordered_map<RouteKey, EntryList::iterator, KeyHash> index_;
+    std::unordered_multimap<NodeKey, Occurrence, KeyHash> nodeIndex_;
+    // Component labels of the most recently searched map versions. Edits drop rather than update
+    // them, since searches read them unlocked.
+    LabelCache labels_;
+    std::size_t hits_ = 0;
+    std::size_t subpathHits_ = 0;
+    std::size_t misses_ = 0;
+
+    static ConfigKey configKey(uint64_t mapVersion, const EngineOptions& options);
+    static bool isOptimal(const EngineOptions& options);
+
+    bool lookup(const RouteKey& key, Result& out);
+    void insert(const RouteKey& key, const Result& result, bool optimal, int width, const TerrainCosts& terrain);
+    void erase(EntryList::iterator it);
+
+  public:
+    /**
+     * @param capacity Maximum number of cached routes (at least 1).
+     */
+    explicit RouteCache(std::size_t capacity);
+
+    /**
+     * @brief PathfindingEngine::findPath through the cache.
+     *
+     * @param mapVersion Identifies the grid and terrain contents. Use a new version whenever either
+     * changes, or report a wall edit with invalidateCell().
+     *
+     * @return The route, with Result::cacheHit set when it came from the cache (visited is then
+     * empty and time is the lookup time). Only SUCCESS and NO_PATH results are cached; searches cut
+     * short by a budget are returned but not stored.
+     */
+    Result findPath(
+        const uint8_t* grid,
+        std::size_t gridSize,
+        int width,
+        int height,
+        int startIndex,
+        int goalIndex,
+        const EngineOptions& options,
+        uint64_t mapVersion);
+
+    /**
+     * @brief Drop every entry of a map version, and its component labels.
+     */
+    void invalidate(uint64_t mapVersion);
+
+    /**
+     * @brief Keep a map version's entries consistent with a single cell edit.
+     *
+     * A new wall only breaks the routes through it, so only those are dropped: routes whose cell
+     * path, any-angle segments, waypoint segments or chain code cross the cell, and, for routes
+     * searched with dontCrossCorners, diagonal steps that pass beside it. A removed wall may
+     * shorten or open any route, so the whole version is dropped. Either way the version's
+     * component labels are dropped and relabelled on its next miss.
+     */
+    void invalidateCell(uint64_t mapVersion, NodeId cell, bool blocked);
+
+    void clear();
+
+    std::size_t size() const;
+    std::size_t hits() const;
+    std::size_t subpathHits() const;
+    std::size_t misses() const;
+};
@@ -0,0 +1,40 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "types/Structs.hh"
+#include "graph/IGraph.hh"
+#include "heuristics/IHeuristic.hh"
+#include "algorithms/IAlgorithm.hh"
+
+/**
+ * @brief Anytime Repairing A* (ARA*) implementation.
+ *
+ * ARA* first runs a weighted A* with w = config.weight to get a solution quickly, then lowers
+ * the weight by config.weightStep and repairs the search, reusing the work of previous passes,
+ * until the weight reaches 1 or config.deadline passes. The best path found so far is returned
+ * together with the bound it is proven to satisfy (Result::suboptimalityBound).
+ */
+class ARAStar : public IAlgorithm {
+
+  public:
+    /**
+     * @brief Find a path from start to goal, improving it until the deadline.
+     * 
+     * @param graph The graph on which to perform the search.
+     * @param start The starting node's NodeId.
+     * @param goal The goal node's NodeId.
+     * @param config Configuration options for the algorithm.
+     * 
+     * @return A Result structure containing the path, visited nodes, total cost, time taken,
+     * success status and achieved suboptimality bound.
+     * 
+     * @note If the budget (deadline, expansion limit, cancellation) runs out during the first pass,
+     * a partial Result towards the goal is returned as with the other algorithms. Later passes
+     * only improve the bound, so running out during them keeps the last solution.
+     */
+    Result findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) override;
+};
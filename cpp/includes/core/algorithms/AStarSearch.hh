@@ -0,0 +1,80 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+#include "types/Structs.hh"
+#include "graph/IGraph.hh"
+#include "algorithms/IAlgorithm.hh"
+
+/**
+ * @brief One A* search whose open list, scores and parents live in the object, so it can be
+ * expanded a slice at a time.
+ *
+ * AStar::findPath runs it to completion in one call; ResumableQuery runs it in slices. Both get the
+ * same search: tie-breaking, canonical ordering, CostPrecision, the per-node ParentMap and
+ * config.memory for every array.
+ *
+ * Without a heuristic the search orders nodes by g alone, i.e. runs Dijkstra: the same costs as
+ * Dijkstra::findPath, though ties may pick another path of equal cost.
+ *
+ * The graph, the heuristic and config.memory must stay alive and unchanged until the search is
+ * destroyed.
+ */
+class AStarSearch {
+
+  public:
+    virtual ~AStarSearch() = default;
+
+    /**
+     * @brief Prepare a search in config.precision; no node is expanded until the first run().
+     *
+     * @param informed False runs Dijkstra order and ignores config.heuristic, tieBreaking and
+     * canonicalOrdering.
+     *
+     * @note Invalid input (missing heuristic, start/goal out of range) logs an error and leaves the
+     * search done with SearchStatus::INVALID_INPUT.
+     */
+    static std::unique_ptr<AStarSearch> create(
+        const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config, bool informed = true);
+
+    /**
+     * @brief Expand nodes until the search ends, sliceEnd passes or maxExpansions nodes were
+     * expanded in this call (0 = no limit).
+     *
+     * The clock is read every few expansions, so a slice can overrun by a handful of them.
+     * config.deadline, maxExpansions and cancel still apply to the search as a whole.
+     *
+     * @return True once the search is done.
+     */
+    virtual bool run(
+        std::chrono::steady_clock::time_point sliceEnd = std::chrono::steady_clock::time_point::max(),
+        std::size_t maxExpansions = 0) = 0;
+
+    /**
+     * @brief Whether the search has finished (found the goal, proved there is none, or stopped).
+     */
+    virtual bool done() const = 0;
+
+    /**
+     * @brief The search result. Complete once done(); before that only visited is filled in.
+     * Result::time is the time spent in create() and run(), not the wall time in between.
+     */
+    virtual const Result& result() const = 0;
+
+    /**
+     * @brief Move the result out, once done(); result() is left empty.
+     */
+    virtual Result release() = 0;
+
+    /**
+     * @brief Nodes expanded so far, over all slices.
+     */
+    virtual std::size_t expansions() const = 0;
+};
@@ -0,0 +1,25 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+
+/**
+ * @brief Flag shared between a running search and whoever may want to stop it.
+ *
+ * Searches poll it cooperatively (see SearchBudget), so cancel() takes effect within a few
+ * expansions rather than immediately.
+ */
+class CancellationToken {
+
+  private:
+    std::atomic<bool> cancelled_{false};
+
+  public:
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    void reset() { cancelled_.store(false, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,48 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "types/Structs.hh"
+#include "graph/IGraph.hh"
+
+/**
+ * @brief Freeman chain code of a grid path: its first node, then one byte per step.
+ *
+ * Codes count counter-clockwise from east with y pointing down: 0 east, 1 north-east, 2 north,
+ * 3 north-west, 4 west, 5 south-west, 6 south, 7 south-east. A path of n cells takes n - 1 bytes
+ * instead of n NodeIds.
+ */
+class ChainCode {
+
+  public:
+    /**
+     * @brief Fill result.chainStart and result.chainCode from result.path.
+     *
+     * Leaves the chain code empty when the path has fewer than two nodes or takes a step that is
+     * not between 8-neighbours (any-angle searches).
+     */
+    static void apply(const IGraph& graph, Result& result);
+
+    /**
+     * @brief Codes of the steps of path into codes.
+     * @return False, with codes cleared, if some step does not join two 8-neighbours.
+     */
+    static bool encode(const IGraph& graph, const std::pmr::vector<NodeId>& path, std::pmr::vector<uint8_t>& codes);
+
+    /**
+     * @brief The cells of a chain code on a grid of the given width, start included.
+     */
+    static std::vector<NodeId> decode(NodeId start, int width, const std::pmr::vector<uint8_t>& codes);
+
+    /**
+     * @brief The (dx, dy) move of a code (only its low 3 bits are read).
+     */
+    static Point step(uint8_t code);
+};
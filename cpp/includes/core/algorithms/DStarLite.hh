@@ -0,0 +1,104 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "types/Structs.hh"
+#include "graph/GridGraph.hh"
+#include "heuristics/IHeuristic.hh"
+#include "algorithms/IAlgorithm.hh"
+#include "algorithms/StatsRecorder.hh"
+
+/**
+ * @brief D* Lite incremental planner.
+ *
+ * Unlike the IAlgorithm implementations, a DStarLite instance keeps its search state (g/rhs values
+ * and open list) between calls. The search runs backward from the goal, so after cells change or
+ * the start moves only the affected part of the search tree is repaired by the next replan().
+ *
+ * The planner reads the GridGraph it was given; callers change cells through setCell() so the
+ * graph and the search state stay in sync.
+ */
+class DStarLite {
+
+  private:
+    using Key = std::pair<Cost, Cost>;
+
+    struct OpenEntry {
+      Key key;
+      NodeId id;
+      bool operator>(const OpenEntry& o) const { return key > o.key; }
+    };
+
+    GridGraph& graph_;
+    AlgorithmConfig config_;
+    NodeId start_;
+    NodeId goal_;
+    NodeId lastStart_;
+    Cost km_ = 0.0;
+    bool initialized_ = false;
+
+    std::vector<Cost> g_;
+    std::vector<Cost> rhs_;
+    std::vector<Key> openKey_;
+    std::vector<bool> inOpen_;
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open_;
+    std::vector<Edge> edges_;
+    std::vector<Edge> scratch_;
+    // Points at the recorder of the replan() in progress; null between calls.
+    StatsRecorder* stats_ = nullptr;
+
+    void initialize();
+    Key calculateKey(NodeId s);
+    void updateVertex(NodeId u);
+    void computeShortestPath(Result& res, StatsRecorder& stats);
+    bool moveAllowed(Point from, Point to) const;
+    void collectSuccessors(NodeId u, std::vector<Edge>& out) const;
+    void collectPredecessors(NodeId u, std::vector<Edge>& out) const;
+    bool topKey(Key& key);
+
+  public:
+    /**
+     * @brief Create a planner over graph.
+     *
+     * @param graph The grid to plan on. Must outlive the planner.
+     * @param config Algorithm options; config.heuristic is required and must be consistent.
+     * @param start The starting node's NodeId.
+     * @param goal The goal node's NodeId.
+     */
+    DStarLite(GridGraph& graph, const AlgorithmConfig& config, NodeId start, NodeId goal);
+
+    /**
+     * @brief Move the start (e.g. the agent advanced along the path). Search state is kept.
+     */
+    void setStart(NodeId start);
+
+    /**
+     * @brief Change the goal. The backward search is rooted at the goal, so this starts over.
+     */
+    void setGoal(NodeId goal);
+
+    /**
+     * @brief Add or remove a wall and schedule the affected nodes for repair.
+     *
+     * @param cell The NodeId of the cell that changed.
+     * @param blocked True if the cell becomes a wall, false if it becomes walkable.
+     */
+    void setCell(NodeId cell, bool blocked);
+
+    /**
+     * @brief Repair the search after the changes made since the last call and return the path.
+     *
+     * @return A Result whose visited list holds only the nodes expanded by this repair.
+     *
+     * @note If any information required but not provided or not valid, the method will return a
+     * Result with success = false, and log an error message.
+     */
+    Result replan();
+};
@@ -0,0 +1,97 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include "types/Usings.hh"
+
+/**
+ * @brief Distances and heap of a Dijkstra that one thread runs from many sources in turn.
+ *
+ * DistanceMatrix and PathDatabase run a Dijkstra per source. Each thread allocates one workspace,
+ * and reset() puts back only the nodes the last search touched. A search then costs what it
+ * explores, not the size of the graph.
+ *
+ * The caller owns relaxation: it compares a new cost against dist() and calls improve(). Node
+ * state the workspace does not know about can be reset by walking touched() before reset().
+ */
+class DijkstraWorkspace {
+
+  public:
+    using Entry = std::pair<Cost, NodeId>;
+
+    static constexpr Cost kInfinity = std::numeric_limits<Cost>::infinity();
+
+  private:
+    std::pmr::vector<Cost> dist_;
+    std::pmr::vector<NodeId> touched_;
+    std::pmr::vector<Entry> heap_;
+
+  public:
+    /**
+     * @brief Distances for n nodes, all at infinity, allocated from memory.
+     */
+    DijkstraWorkspace(NodeCount n, std::pmr::memory_resource* memory)
+        : dist_(n, kInfinity, memory), touched_(memory), heap_(memory) {}
+
+    /**
+     * @brief Begin a search: source gets distance 0 and is the only open node.
+     */
+    void start(NodeId source) { improve(source, 0.0); }
+
+    /**
+     * @brief Take the open node with the smallest distance, skipping entries a shorter one replaced.
+     *
+     * @return False once no open node is left.
+     */
+    bool pop(Cost& d, NodeId& u) {
+      while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+        const Entry top = heap_.back();
+        heap_.pop_back();
+        if (top.first != dist_[top.second]) continue;
+        d = top.first;
+        u = top.second;
+        return true;
+      }
+      return false;
+    }
+
+    /**
+     * @brief Best distance found so far to v (kInfinity if none).
+     */
+    Cost dist(NodeId v) const { return dist_[v]; }
+
+    /**
+     * @brief Lower v's distance to d and open it again.
+     */
+    void improve(NodeId v, Cost d) {
+      if (dist_[v] == kInfinity) touched_.push_back(v);
+      dist_[v] = d;
+      heap_.push_back({d, v});
+      std::push_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+    }
+
+    /**
+     * @brief Every node given a distance since the last reset(), each once.
+     */
+    const std::pmr::vector<NodeId>& touched() const { return touched_; }
+
+    /**
+     * @brief Return the touched nodes to infinity and empty the heap, ready for the next source.
+     */
+    void reset() {
+      for (const NodeId v : touched_) dist_[v] = kInfinity;
+      touched_.clear();
+      heap_.clear();
+    }
+};
@@ -0,0 +1,46 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "types/Structs.hh"
+#include "graph/IGraph.hh"
+
+/**
+ * @brief Dense shortest-path cost matrix between two sets of nodes.
+ *
+ * One Dijkstra per source, stopped as soon as every target the source can reach is settled,
+ * instead of one search per (source, target) pair. Sources are spread over worker threads; each
+ * keeps its distance array and heap in its own QueryArena and only resets the entries a search
+ * touched, so the next source does not pay for the whole graph again.
+ */
+class DistanceMatrix {
+
+  public:
+    // Tells whether a path from the first node to the second can exist. Pairs it rules out are
+    // left at infinity without being waited for, so a search ends once the others are settled.
+    using ReachFilter = std::function<bool(NodeId, NodeId)>;
+
+    /**
+     * @brief Entry s * targets.size() + t is the cost of a shortest path from sources[s] to
+     * targets[t], infinity when there is none.
+     *
+     * Edge costs come from the graph; with allowDiagonal false, diagonal moves are skipped as
+     * Dijkstra does. Out-of-range sources and targets give infinity.
+     *
+     * @param maxThreads Upper bound on the threads used, the caller included (0 = one per core).
+     * @param mayReach Optional filter, e.g. component labels; nullptr waits for every target.
+     */
+    static std::vector<Cost> compute(
+        const IGraph& graph,
+        const std::vector<NodeId>& sources,
+        const std::vector<NodeId>& targets,
+        bool allowDiagonal,
+        unsigned maxThreads = 0,
+        const ReachFilter& mayReach = nullptr);
+};
@@ -0,0 +1,38 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "types/Structs.hh"
+#include "graph/IGraph.hh"
+#include "heuristics/IHeuristic.hh"
+#include "algorithms/IAlgorithm.hh"
+
+/**
+ * @brief Focal search (A*epsilon) implementation.
+ *
+ * Keeps the usual open list ordered by f = g + h, plus a FOCAL list holding every open node with
+ * f <= w * min f, where w = config.weight. Nodes are expanded from FOCAL in order of their
+ * distance-to-go h, which heads straight for the goal while guaranteeing cost <= w * optimal.
+ */
+class FocalSearch : public IAlgorithm {
+
+  public:
+    /**
+     * @brief Find a path from start to goal within a factor config.weight of optimal.
+     * 
+     * @param graph The graph on which to perform the search.
+     * @param start The starting node's NodeId.
+     * @param goal The goal node's NodeId.
+     * @param config Configuration options for the algorithm.
+     * 
+     * @return A Result structure containing the path, visited nodes, total cost, time taken,
+     * success status and achieved suboptimality bound.
+     * 
+     * @note If any information required but not provided or not valid, the method will return a
+     * Result with success = false, and log an error message.
+     */
+    Result findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) override;
+};
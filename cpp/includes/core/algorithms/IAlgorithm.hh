@@ -5,19 +5,63 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <memory_resource>
+#include <cstddef>
 #include <cstdint>
 
 #include "types/Structs.hh"
+#include "types/Enums.hh"
 #include "graph/IGraph.hh"
 #include "heuristics/IHeuristic.hh"
+#include "algorithms/CancellationToken.hh"
 
+/**
+ * @brief Options shared by every algorithm; each one reads the fields that apply to it.
+ *
+ * @param weight Heuristic inflation w >= 1. A* searches with f = g + w*h (weighted A*), ARA*
+ * starts from it, focal search uses it as its suboptimality bound. 1 keeps searches optimal.
+ * @param weightStep How much ARA* lowers its weight between improving passes.
+ * @param deadline Point in time after which a search stops: ARA* returns its best path, every
+ * other algorithm returns a partial Result with SearchStatus::TIMEOUT.
+ * @param maxExpansions Stop with SearchStatus::EXPANSION_LIMIT after this many expansions (0 = no limit).
+ * @param cancel Token another thread can trip to stop the search with SearchStatus::CANCELLED.
+ * @param transpositionTableSize Entries in IDA*'s transposition table (0 disables it).
+ * @param tieBreaking How A* orders open nodes with equal f.
+ * @param onVisited Receives the expanded nodes in chunks of visitChunkSize when recording is
+ * VisitedRecording::STREAM.
+ * @param canonicalOrdering A* on 8-connected uniform-cost grids only generates the successors a
+ * canonical (diagonal-first) path can continue with, plus forced neighbours next to walls. Paths
+ * stay optimal; ignored on other graphs. It halves expansions on open maps under TieBreaking::NONE
+ * and is within a few percent either way with HIGH_G or LIFO; CROSS_PRODUCT is replaced by HIGH_G,
+ * as the two orderings work against each other.
+ * @param precision Number type A* and Dijkstra keep their scores in; see CostPrecision.
+ * @param memory Where A*, Dijkstra, BFS and DFS allocate their per-search arrays and open list. The
+ * engine points it at a per-thread QueryArena; it must outlive the search.
+ * @param resultMemory Where the returned Result's arrays are allocated; must outlive the Result.
+ */
 struct AlgorithmConfig {
   std::shared_ptr<const IHeuristic> heuristic = nullptr;
   bool allowDiagonal = false;
   Cost diagonalCost = 1.41421356237;
   bool dontCrossCorners = false;
   bool bidirectional = false;
+  VisitedRecording recording = VisitedRecording::FULL;
+  uint32_t recordingSampleRate = 16;
+  VisitSink onVisited = nullptr;
+  std::size_t visitChunkSize = 1024;
+  Cost weight = 1.0;
+  Cost weightStep = 0.5;
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+  std::size_t maxExpansions = 0;
+  std::shared_ptr<const CancellationToken> cancel = nullptr;
+  std::size_t transpositionTableSize = 1 << 16;
+  TieBreaking tieBreaking = TieBreaking::NONE;
+  bool canonicalOrdering = false;
+  CostPrecision precision = CostPrecision::DOUBLE;
+  std::pmr::memory_resource* memory = std::pmr::get_default_resource();
+  std::pmr::memory_resource* resultMemory = std::pmr::get_default_resource();
 };
 
 /**
@@ -43,6 +87,8 @@ class IAlgorithm {
      * 
      * @note If any information required but not provided or not valid, the method will return a
      * Result with success, and log an error message.
+     * @note Searches honour config.deadline, config.maxExpansions and config.cancel; when one of
+     * them stops the search, Result::status says which and the path is a partial one.
      */
     virtual Result findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) = 0;
 
@@ -16,6 +16,20 @@
  * IDA* performs a series of depth-first searches with increasing f-cost
  * thresholds. It combines the space efficiency of DFS with heuristic
  * pruning from A*.
+ *
+ * The depth-first search runs on an explicit stack, so path length is not limited by the call
+ * stack. Children are tried in order of f, and a bounded transposition table
+ * (AlgorithmConfig::transpositionTableSize) prunes nodes already reached with a smaller or equal g
+ * in the same iteration, which stops the re-expansion blow-up on open grids.
+ *
+ * Thresholds grow IDA*_CR style: rather than to the smallest f the last iteration cut off, the
+ * next threshold is raised far enough to admit about as many cut-off nodes as the iteration
+ * expanded, so each iteration roughly doubles the work. With octile moves or terrain costs, where
+ * nearly every path has its own f, that keeps the number of iterations logarithmic. A threshold
+ * may then overshoot the optimal cost: the first solution found is kept, the iteration continues
+ * for strictly cheaper ones, and the best is returned once the iteration completes (or at once
+ * when it matches the proven lower bound). If the budget interrupts that iteration, the solution
+ * is returned with Result::suboptimalityBound set from the lower bound.
  */
 class IDAStar : public IAlgorithm {
 
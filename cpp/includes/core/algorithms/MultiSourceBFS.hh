@@ -0,0 +1,61 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "types/Structs.hh"
+#include "graph/IGraph.hh"
+
+/**
+ * @brief Hop distances from many sources at once (multi-source BFS with bit-sliced frontiers).
+ *
+ * Up to kMaxLanes breadth-first searches run together, one bit per source in every cell's seen,
+ * frontier and next-frontier sets. A cell is expanded once per level for all the sources that
+ * reached it in the previous level, so the neighbour list is fetched once and the sets are
+ * updated a 64-bit word (256 bits, four words, when there are that many sources) at a time.
+ * More sources are handled in successive batches.
+ *
+ * Moves follow BFS: diagonals only with allowDiagonal, and with dontCrossCorners only when both
+ * cells beside the corner are neighbours too. Every move counts one hop whatever its cost.
+ */
+class MultiSourceBFS {
+
+  public:
+    // Hop count of a cell no path reaches.
+    static constexpr uint32_t kUnreachable = std::numeric_limits<uint32_t>::max();
+
+    // Sources searched in one traversal.
+    static constexpr std::size_t kMaxLanes = 256;
+
+    /**
+     * @brief Distance field of every source: entry s * nodeCount + v is the hop count from
+     * sources[s] to v.
+     *
+     * Out-of-range sources get a row of kUnreachable.
+     */
+    static std::vector<uint32_t> distanceFields(
+        const IGraph& graph,
+        const std::vector<NodeId>& sources,
+        bool allowDiagonal,
+        bool dontCrossCorners);
+
+    /**
+     * @brief Hop counts between sources and targets: entry s * targets.size() + t is the hop count
+     * from sources[s] to targets[t].
+     *
+     * A batch stops as soon as all of its sources have reached every target.
+     */
+    static std::vector<uint32_t> distanceMatrix(
+        const IGraph& graph,
+        const std::vector<NodeId>& sources,
+        const std::vector<NodeId>& targets,
+        bool allowDiagonal,
+        bool dontCrossCorners);
+};
@@ -0,0 +1,79 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "graph/IGraph.hh"
+#include "types/Usings.hh"
+
+/**
+ * @brief Search-tree parents, one per node.
+ *
+ * On grids (IGraph::getGridStride() != 0) a parent is always one of the 8 neighbours, so it is
+ * kept as a direction code in half a byte, two nodes per byte: 8 times less memory than a NodeId
+ * per node. Other graphs get a plain NodeId array.
+ */
+class ParentMap {
+
+  private:
+    // Code (dy + 1) * 3 + (dx + 1) of the parent relative to the node; 4 is the node itself.
+    static constexpr uint8_t kNoCode = 0xF;
+
+    long stride_;
+    std::pmr::vector<uint8_t> codes_;
+    std::pmr::vector<NodeId> ids_;
+
+  public:
+    static constexpr NodeId kNone = static_cast<NodeId>(-1);
+
+    /**
+     * @brief Room for n nodes, none with a parent yet, allocated from memory.
+     */
+    ParentMap(const IGraph& graph, NodeCount n, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : stride_(graph.getGridStride()), codes_(memory), ids_(memory) {
+      // Below width 3 an id difference no longer tells the direction apart (width 2: +1 is east
+      // or south-west).
+      if (stride_ >= 3) codes_.assign((static_cast<std::size_t>(n) + 1) / 2, 0xFF);
+      else ids_.assign(n, kNone);
+    }
+
+    /**
+     * @brief Make parent the parent of v. On grids, parent must be v or one of its 8 neighbours.
+     */
+    void set(NodeId v, NodeId parent) {
+      if (codes_.empty()) {
+        ids_[v] = parent;
+        return;
+      }
+      const long delta = static_cast<long>(parent) - static_cast<long>(v);
+      const long dy = delta < -1 ? -1 : (delta > 1 ? 1 : 0);
+      const long dx = delta - dy * stride_;
+      const auto code = static_cast<uint8_t>((dy + 1) * 3 + (dx + 1));
+      uint8_t& byte = codes_[v / 2];
+      byte = (v & 1) ? static_cast<uint8_t>((byte & 0x0F) | (code << 4)) : static_cast<uint8_t>((byte & 0xF0) | code);
+    }
+
+    /**
+     * @brief The parent of v, or kNone.
+     */
+    NodeId get(NodeId v) const {
+      if (codes_.empty()) return ids_[v];
+      const unsigned code = (v & 1) ? (codes_[v / 2] >> 4) : (codes_[v / 2] & 0x0F);
+      if (code == kNoCode) return kNone;
+      const long dy = static_cast<long>(code / 3) - 1;
+      const long dx = static_cast<long>(code % 3) - 1;
+      return static_cast<NodeId>(static_cast<long>(v) + dy * stride_ + dx);
+    }
+
+    /**
+     * @brief Heap bytes held, for the workspace statistics.
+     */
+    std::size_t bytes() const { return codes_.capacity() + ids_.capacity() * sizeof(NodeId); }
+};
@@ -0,0 +1,47 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+
+#include "types/Structs.hh"
+#include "types/Enums.hh"
+#include "graph/IGraph.hh"
+
+/**
+ * @brief Post-processing that reduces a cell-by-cell path to waypoints.
+ *
+ * Runs after the search, on its Result, and never changes Result::path or Result::cost.
+ */
+class PathSmoother {
+
+  public:
+    /**
+     * @brief Fill result.waypoints and result.waypointCost from result.path.
+     *
+     * STRING_PULL needs IGraph::lineOfSight on a uniform-cost grid; on other graphs it falls back
+     * to WAYPOINTS, whose cost is the path's own. Does nothing for NONE or an empty path.
+     */
+    static void apply(const IGraph& graph, PathSmoothing mode, Result& result);
+
+    /**
+     * @brief The path's first and last nodes plus every node where its direction changes, into out.
+     */
+    static void turningPoints(const IGraph& graph, const std::pmr::vector<NodeId>& path, std::pmr::vector<NodeId>& out);
+
+    /**
+     * @brief Greedy string pulling: from each waypoint, skip ahead to the last path node it still
+     * sees. Consecutive path nodes are always kept connected, even where the path squeezes
+     * diagonally past a corner that blocks line of sight. The waypoints go into out.
+     */
+    static void stringPull(const IGraph& graph, const std::pmr::vector<NodeId>& path, std::pmr::vector<NodeId>& out);
+
+    /**
+     * @brief Euclidean length of a polyline through the nodes' positions.
+     */
+    static Cost length(const IGraph& graph, const std::pmr::vector<NodeId>& waypoints);
+};
@@ -0,0 +1,88 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
+#include "types/Usings.hh"
+#include "graph/IGraph.hh"
+
+/**
+ * @brief The number type a search keeps its g and f scores in, selected by CostPrecision.
+ *
+ * Edge costs and heuristics stay Cost; the search converts g scores with from() and f scores with
+ * fromBelow() as it relaxes and compares in S. from() never rounds an edge cost down and
+ * fromBelow() never rounds an estimate up, so in fixed point, where sums are exact, an admissible
+ * heuristic stays admissible. Narrower scores halve the score arrays and the open-list entries,
+ * the data a search streams through on every expansion.
+ *
+ * - double: exact, as before.
+ * - float: 24-bit mantissa, about 7 significant digits.
+ * - int32_t: fixed point with kScale steps per unit of cost, saturating at infinity().
+ */
+template <typename S>
+struct ScoreTraits;
+
+template <>
+struct ScoreTraits<double> {
+  static constexpr bool kExact = true;
+  static double infinity() { return std::numeric_limits<double>::infinity(); }
+  static double from(Cost c) { return c; }
+  static double fromBelow(Cost c) { return c; }
+  static Cost to(double s) { return s; }
+  static double add(double a, double b) { return a + b; }
+};
+
+template <>
+struct ScoreTraits<float> {
+  static constexpr bool kExact = false;
+  static float infinity() { return std::numeric_limits<float>::infinity(); }
+  static float from(Cost c) { return static_cast<float>(c); }
+  static float fromBelow(Cost c) {
+    const float s = static_cast<float>(c);
+    return s > c ? std::nextafter(s, -infinity()) : s;
+  }
+  static Cost to(float s) { return static_cast<Cost>(s); }
+  static float add(float a, float b) { return a + b; }
+};
+
+template <>
+struct ScoreTraits<int32_t> {
+  static constexpr bool kExact = false;
+  // 1/1024 of a step: sqrt(2) becomes 1449/1024, 5e-4 relative too long, and paths up to about
+  // 2 million unit steps fit. Rounding edges up and estimates down keeps the octile and Euclidean
+  // heuristics below every scaled path; rounding both to nearest would put them above long
+  // diagonal runs (1448 per step against sqrt(2) * 1024 = 1448.15).
+  static constexpr Cost kScale = 1024.0;
+  static int32_t infinity() { return std::numeric_limits<int32_t>::max(); }
+  static int32_t saturate(Cost s) {
+    if (!(s < static_cast<Cost>(infinity()))) return infinity();
+    return static_cast<int32_t>(s);
+  }
+  static int32_t from(Cost c) { return saturate(std::ceil(c * kScale)); }
+  static int32_t fromBelow(Cost c) { return saturate(std::floor(c * kScale)); }
+  static Cost to(int32_t s) { return s == infinity() ? std::numeric_limits<Cost>::infinity() : s / kScale; }
+  static int32_t add(int32_t a, int32_t b) {
+    const int64_t sum = int64_t{a} + int64_t{b};
+    return sum >= int64_t{infinity()} ? infinity() : static_cast<int32_t>(sum);
+  }
+};
+
+/**
+ * @brief Sum of the edge costs along a path, in Cost.
+ *
+ * Searches that did not keep exact scores report this, so a narrow precision can only change
+ * which path is returned, never misstate its cost.
+ */
+inline Cost pathCost(const IGraph& graph, const std::pmr::vector<NodeId>& path) {
+  Cost total = 0.0;
+  for (std::size_t i = 1; i < path.size(); ++i) total += graph.getEdgeCost(path[i - 1], path[i]);
+  return total;
+}
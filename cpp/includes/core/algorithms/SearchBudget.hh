@@ -0,0 +1,82 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+#include "types/Structs.hh"
+#include "types/Enums.hh"
+#include "algorithms/IAlgorithm.hh"
+
+/**
+ * @brief Enforces AlgorithmConfig's deadline, expansion limit and cancellation token.
+ *
+ * Algorithms call exhausted() once per expansion and stop when it returns true. The clock and the
+ * token are only polled every few expansions. When no limit is configured, exhausted() is a
+ * counter increment and one branch.
+ *
+ * A limited budget also remembers the expanded node closest to the goal so an interrupted search
+ * can return a partial path towards it. That costs a heuristic evaluation per expansion, so it is
+ * skipped entirely when no limit is configured: such a search can only stop by finishing.
+ */
+class SearchBudget {
+
+  private:
+    const AlgorithmConfig& config_;
+    NodeId goal_;
+    bool limited_;
+    std::size_t expansions_ = 0;
+    SearchStatus status_ = SearchStatus::SUCCESS;
+    NodeId closest_;
+    Cost closestH_ = std::numeric_limits<Cost>::infinity();
+
+    bool pollSlow();
+
+    // Considers u as the best-so-far node for a partial result. Only called on limited budgets.
+    void offer(NodeId u);
+
+  public:
+    SearchBudget(const AlgorithmConfig& config, NodeId start, NodeId goal);
+
+    /**
+     * @brief Count one expansion of node u.
+     * @return True when the search must stop; status() tells why.
+     */
+    bool exhausted(NodeId u) {
+      ++expansions_;
+      if (!limited_) return false;
+      offer(u);
+      if (config_.maxExpansions != 0 && expansions_ > config_.maxExpansions) {
+        status_ = SearchStatus::EXPANSION_LIMIT;
+        return true;
+      }
+      return (expansions_ % 64 == 0) && pollSlow();
+    }
+
+    /**
+     * @brief Whether any limit is configured (otherwise exhausted() never returns true).
+     */
+    bool limited() const { return limited_; }
+
+    /**
+     * @brief The reason the search was stopped, SUCCESS if it was not.
+     */
+    SearchStatus status() const { return status_; }
+
+    /**
+     * @brief Number of expansions counted so far.
+     */
+    std::size_t expansions() const { return expansions_; }
+
+    /**
+     * @brief The expanded node with the smallest heuristic distance to the goal (the last one
+     * expanded when no heuristic is configured).
+     *
+     * @note Only tracked when limited(); otherwise this stays the start node.
+     */
+    NodeId closest() const { return closest_; }
+};
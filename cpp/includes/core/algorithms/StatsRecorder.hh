@@ -0,0 +1,102 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "types/Structs.hh"
+
+// Build with -DPATHFINDING_STATS=0 to compile every counter below down to nothing.
+#ifndef PATHFINDING_STATS
+#define PATHFINDING_STATS 1
+#endif
+
+/**
+ * @brief Collects SearchStats into a Result while a search runs.
+ *
+ * Algorithms call the counting methods from their hot loops; each one is an inline increment, and
+ * with PATHFINDING_STATS=0 an empty function the compiler removes. Phase timings read the clock
+ * once per phase boundary, never per expansion.
+ */
+class StatsRecorder {
+
+  private:
+#if PATHFINDING_STATS
+    SearchStats& stats_;
+    std::chrono::steady_clock::time_point mark_;
+
+    Time lap() {
+      const auto now = std::chrono::steady_clock::now();
+      const Time elapsed = std::chrono::duration_cast<Time>(now - mark_);
+      mark_ = now;
+      return elapsed;
+    }
+#endif
+
+  public:
+    /**
+     * @brief Start recording into result.stats; the setup phase starts now.
+     */
+#if PATHFINDING_STATS
+    explicit StatsRecorder(Result& result) : stats_(result.stats), mark_(std::chrono::steady_clock::now()) {}
+#else
+    explicit StatsRecorder(Result&) {}
+#endif
+
+#if PATHFINDING_STATS
+    void expanded() { ++stats_.expansions; }
+    void generated() { ++stats_.generated; }
+    void popped() { ++stats_.pops; }
+    void stalePop() { ++stats_.stalePops; }
+    void heuristicCall() { ++stats_.heuristicCalls; }
+
+    /**
+     * @brief Count an open-list insertion that left the list holding openSize entries.
+     */
+    void pushed(std::size_t openSize) {
+      ++stats_.pushes;
+      if (openSize > stats_.peakOpen) stats_.peakOpen = openSize;
+    }
+
+    /**
+     * @brief Add bytes of search workspace (per-node arrays, open list at its peak).
+     */
+    void workspace(std::size_t bytes) { stats_.workspaceBytes += bytes; }
+
+    void endSetup() { stats_.setupTime += lap(); }
+    void endSearch() { stats_.searchTime += lap(); }
+    void endReconstruct() { stats_.reconstructTime += lap(); }
+
+    /**
+     * @brief Start timing again without charging the time since the last phase to any of them
+     * (a search that runs in slices calls this at the start of each slice).
+     */
+    void resume() { mark_ = std::chrono::steady_clock::now(); }
+#else
+    void expanded() {}
+    void generated() {}
+    void popped() {}
+    void stalePop() {}
+    void heuristicCall() {}
+    void pushed(std::size_t) {}
+    void workspace(std::size_t) {}
+    void endSetup() {}
+    void endSearch() {}
+    void endReconstruct() {}
+    void resume() {}
+#endif
+
+    /**
+     * @brief Bytes reserved by a vector, for workspace().
+     */
+    template <typename T, typename Allocator>
+    static std::size_t bytes(const std::vector<T, Allocator>& v) { return v.capacity() * sizeof(T); }
+
+    template <typename Allocator>
+    static std::size_t bytes(const std::vector<bool, Allocator>& v) { return v.capacity() / 8; }
+};
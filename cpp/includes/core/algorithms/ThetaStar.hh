@@ -0,0 +1,52 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "types/Structs.hh"
+#include "graph/IGraph.hh"
+#include "heuristics/IHeuristic.hh"
+#include "algorithms/IAlgorithm.hh"
+
+/**
+ * @brief Theta* and Lazy Theta*: any-angle variants of A*.
+ *
+ * A successor may take its parent's parent as its own parent whenever the two see each other
+ * (IGraph::lineOfSight), so paths bend only at obstacle corners. Theta* checks line of sight for
+ * every generated successor; Lazy Theta* assumes it and only checks once per expanded node,
+ * falling back to the best expanded neighbour when the assumption was wrong.
+ *
+ * Segment costs are Euclidean lengths times the graph's step cost, so any-angle moves are only
+ * taken on uniform-cost grids; elsewhere both behave like A*. Use the EUCLIDEAN heuristic: the
+ * others overestimate straight segments. Paths are usually, not provably, the shortest any-angle
+ * paths, so Result::suboptimalityBound is left at infinity.
+ */
+class ThetaStar : public IAlgorithm {
+
+  private:
+    bool lazy_;
+
+  public:
+    /**
+     * @param lazy Run Lazy Theta* instead of Theta*.
+     */
+    explicit ThetaStar(bool lazy) : lazy_(lazy) {}
+
+    /**
+     * @brief Find an any-angle path from start to goal.
+     * 
+     * @param graph The graph on which to perform the search.
+     * @param start The starting node's NodeId.
+     * @param goal The goal node's NodeId.
+     * @param config Configuration options for the algorithm.
+     * 
+     * @return A Result whose path lists only the path's vertices: consecutive nodes see each other
+     * but need not be adjacent. cost is the length of that polyline.
+     * 
+     * @note If any information required but not provided or not valid, the method will return a
+     * Result with success = false, and log an error message.
+     */
+    Result findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) override;
+};
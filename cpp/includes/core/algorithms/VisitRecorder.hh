@@ -0,0 +1,81 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "types/Structs.hh"
+#include "types/Enums.hh"
+#include "algorithms/IAlgorithm.hh"
+
+/**
+ * @brief Records expanded nodes into a Result according to AlgorithmConfig::recording.
+ *
+ * Algorithms call record() once per expansion instead of pushing into Result::visited directly.
+ * With VisitedRecording::OFF the call is a single predictable branch and nothing is allocated.
+ * With VisitedRecording::STREAM the nodes go to AlgorithmConfig::onVisited through a buffer of
+ * visitChunkSize entries, so memory stays bounded however long the search runs. The last partial
+ * chunk is only delivered by flush(), which every algorithm calls once its search loop ends; the
+ * destructor does not, since a sink that throws must not be called from one.
+ */
+class VisitRecorder {
+
+  private:
+    Result& result_;
+    VisitedRecording mode_;
+    uint32_t sampleRate_;
+    uint32_t untilSample_ = 0;
+    NodeId lastId_ = 0;  // previous expansion, the base of the next delta (DELTAS only)
+    const VisitSink* sink_ = nullptr;
+    std::size_t chunkSize_ = 0;  // nodes per sink call; reserve() may give chunk_ more capacity
+    std::vector<NodeId> chunk_;
+
+    void recordCompact(NodeId id);
+
+  public:
+    /**
+     * @brief Create a recorder writing into result.
+     *
+     * @param result The Result whose visited fields will be filled.
+     * @param config The algorithm configuration carrying the recording mode.
+     * @param nodeCount Number of nodes in the graph (sizes the bitmap in BITMAP mode).
+     */
+    VisitRecorder(Result& result, const AlgorithmConfig& config, NodeCount nodeCount);
+
+    VisitRecorder(const VisitRecorder&) = delete;
+    VisitRecorder& operator=(const VisitRecorder&) = delete;
+
+    /**
+     * @brief Record one expanded node.
+     */
+    void record(NodeId id) {
+      if (mode_ == VisitedRecording::OFF) return;
+      if (mode_ == VisitedRecording::FULL) {
+        result_.visited.push_back(id);
+        return;
+      }
+      recordCompact(id);
+    }
+
+    /**
+     * @brief Deliver the buffered nodes now rather than when the chunk fills (STREAM only).
+     *
+     * Every search calls this when it stops expanding, and a search that runs in slices at the end
+     * of each slice, so its caller sees every expansion made so far. Exceptions from the sink
+     * propagate to the caller.
+     */
+    void flush();
+
+    /**
+     * @brief Expand Result::visitedDeltas back into the expansion order.
+     *
+     * Each node is stored as its id minus the previous one (0 before the first), zig-zag mapped to
+     * an unsigned code and written low 7 bits first, with the top bit set on every byte but the
+     * last. Neighbour steps on a grid take one or two bytes instead of FULL's four.
+     */
+    static std::vector<NodeId> decodeDeltas(const uint8_t* bytes, std::size_t size);
+};
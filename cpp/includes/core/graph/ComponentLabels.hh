@@ -0,0 +1,76 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "types/Structs.hh"
+
+/**
+ * @brief Connected components of a grid's walkable cells, for both 4- and 8-connectivity.
+ *
+ * Labels are union-find forests flattened after each build, so sameComponent() is a couple of
+ * lookups. They depend only on which cells are walkable, so they can outlive the graph a query
+ * builds: GridGraph keeps one for its own edits, and RouteCache keeps one per map version.
+ */
+class ComponentLabels {
+
+  private:
+    // Walls have parent kNoComponent.
+    struct Forest {
+      std::pmr::vector<NodeId> parent;
+      std::pmr::vector<NodeCount> size;
+    };
+
+    int width_ = 0;
+    int height_ = 0;
+
+    // forests_[0] links 4-neighbours, forests_[1] all 8.
+    Forest forests_[2];
+    bool valid_ = false;
+
+  public:
+    explicit ComponentLabels(std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * @brief Label a width x height grid.
+     *
+     * Rows are split into bands whose 4-connected components are labelled in parallel with
+     * union-find, then the band seams are merged; the 8-connected labels add the diagonal links on
+     * top.
+     *
+     * @param walkBits One bit per cell (bit i % 64 of word i / 64), set when walkable.
+     * @param maxThreads Upper bound on the threads used, the caller included (0 = one per core,
+     * see utils::threadBudget). Keep the default on any per-query path: one band on this thread.
+     */
+    void build(int width, int height, const uint64_t* walkBits, unsigned maxThreads = 1);
+
+    /**
+     * @brief Join the components around a cell that just became walkable.
+     *
+     * @param walkBits The grid's bits, with the cell's bit already set.
+     * @note Does nothing while the labels are stale.
+     */
+    void open(NodeId id, const uint64_t* walkBits);
+
+    /**
+     * @brief Mark the labels stale, e.g. after a new wall that may split a component.
+     */
+    void invalidate() { valid_ = false; }
+
+    bool valid() const { return valid_; }
+
+    /**
+     * @brief Whether two walkable cells can possibly be connected.
+     *
+     * @param allowDiagonal Use 8-connectivity (diagonal moves allowed) instead of 4-connectivity.
+     * @return False only when the labels are current and put a and b in different components;
+     * true otherwise, including when either node is a wall or the labels are stale.
+     */
+    bool sameComponent(NodeId a, NodeId b, bool allowDiagonal) const;
+};
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <limits>
 #include <vector>
 
 #include "types/Usings.hh"
@@ -42,6 +43,55 @@ public:
    */
   virtual Point getNodePosition(NodeId nodeId) const = 0;
 
+  /**
+   * @brief Whether the graph is a grid where every straight move costs the same (and every diagonal
+   * move sqrt(2) times that), so the geometry alone decides which paths are optimal.
+   *
+   * Symmetry reductions such as A*'s canonical ordering are only valid on such graphs.
+   */
+  virtual bool isUniformGrid() const { return false; }
+
+  /**
+   * @brief Lower bound on the cost of a straight move anywhere in the graph (a diagonal move costs
+   * at least sqrt(2) times it).
+   *
+   * Distance heuristics multiply by it, which keeps them admissible on weighted terrain and as
+   * tight as possible when every cell costs more than 1.
+   */
+  virtual Cost getMinStepCost() const { return 1.0; }
+
+  /**
+   * @brief Whether the straight segment between the centres of two nodes crosses only walkable
+   * cells, never squeezing between two blocked cells that touch at a corner.
+   *
+   * Used by any-angle searches and path smoothing. Graphs without that geometry return false,
+   * which leaves every path on its graph edges.
+   */
+  virtual bool lineOfSight(NodeId, NodeId) const { return false; }
+
+  /**
+   * @brief Cost of the edge from one node to another, or infinity when there is no such edge.
+   *
+   * Lets a search total a path it kept no costs for. The default scans getNeighbors(); grids
+   * answer from their cost layer without building the neighbour list.
+   */
+  virtual Cost getEdgeCost(NodeId from, NodeId to) const {
+    std::vector<Edge> edges;
+    getNeighbors(from, edges);
+    for (const Edge& e : edges) {
+      if (e.id == to) return e.cost;
+    }
+    return std::numeric_limits<Cost>::infinity();
+  }
+
+  /**
+   * @brief Row stride of a grid whose node ids are y * stride + x and whose edges only join
+   * 8-neighbours, or 0 for any other graph.
+   *
+   * Searches use it to store each parent as a direction code instead of a full NodeId.
+   */
+  virtual int getGridStride() const { return 0; }
+
   /**
    * @brief Virtual destructor for proper cleanup of derived classes.
    */
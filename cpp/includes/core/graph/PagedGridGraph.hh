@@ -0,0 +1,126 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "graph/IGraph.hh"
+#include "types/Structs.hh"
+
+/**
+ * @brief Grid graph streamed from a tiled map file instead of being held in memory.
+ *
+ * The map is split into square tiles of `tileSize x tileSize` cells. Tiles are read on demand,
+ * kept in an LRU cache bounded by a memory budget, and the next tile along the direction the
+ * search is moving in is prefetched in the background. Node ids, positions and edge costs follow
+ * the same conventions as GridGraph, so every IAlgorithm runs on it unchanged.
+ *
+ * File layout (little endian):
+ *   - header: magic "PFTG", version, width, height, tileSize (5 x uint32, tileSize <= 32768)
+ *   - tiles in row-major tile order, each `tileSize * tileSize` bytes (0 = walkable, else blocked);
+ *     tiles on the right/bottom border are padded with blocked cells.
+ */
+class PagedGridGraph : public IGraph {
+
+  private:
+    struct Tile {
+      std::vector<uint8_t> cells;
+      std::list<int>::iterator lru;
+    };
+
+    std::string path_;
+    int width_;
+    int height_;
+    int tileSize_;
+    int tilesX_;
+    int tilesY_;
+    std::size_t maxResidentTiles_;
+
+    mutable std::mutex mutex_;
+    mutable std::list<int> lru_;
+    mutable std::unordered_map<int, Tile> tiles_;
+    mutable std::unordered_map<int, std::future<std::vector<uint8_t>>> pending_;
+    mutable int lastTile_ = -1;
+    mutable const uint8_t* lastCells_ = nullptr;
+    mutable std::size_t tileLoads_ = 0;
+
+    std::vector<uint8_t> readTile(int tile) const;
+    const uint8_t* acquireTile(int tile) const;
+    void prefetchAlong(int from, int to) const;
+    void evictIfNeeded() const;
+    bool walkableAt(int x, int y) const;
+
+  public:
+    /**
+     * @brief Open a tiled map file.
+     *
+     * @param path Path of a file written by writeTiledMap().
+     * @param memoryBudget Upper bound in bytes for resident and prefetched tiles (at least 4 tiles
+     * are always kept so a neighbor scan never thrashes).
+     *
+     * @throws std::runtime_error If the file cannot be opened, its header is invalid or its length
+     * does not match the tiles the header announces.
+     */
+    PagedGridGraph(const std::string& path, std::size_t memoryBudget);
+
+    /**
+     * @brief Wait for in-flight prefetches before the cache goes away.
+     */
+    ~PagedGridGraph() override;
+
+    /**
+     * @brief Convert a row-major grid (0 = walkable, non-zero = blocked) into a tiled map file.
+     *
+     * @throws std::invalid_argument If the sizes are inconsistent or tileSize is above 32768.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    static void writeTiledMap(const std::string& path, int width, int height, int tileSize,
+                              const std::vector<uint8_t>& grid);
+
+    /**
+     * @brief Get the total number of nodes in the grid graph.
+     * @return The number of nodes.
+     */
+    NodeCount getNodeCount() const override;
+
+    /**
+     * @brief Get the walkable neighbors of a node, loading the tiles they live in if needed.
+     *
+     * @param nodeId The NodeId of the node whose neighbors are to be retrieved.
+     * @param out A vector to be filled with Edge structures representing the neighboring nodes and their costs.
+     *
+     * @note If the nodeId is invalid, the out vector will remain empty, and an error will be logged.
+     */
+    void getNeighbors(NodeId id, std::vector<Edge>& out) const override;
+
+    /**
+     * @brief Get the position of a node. Computed from the id, never touches the file.
+     *
+     * @note If the nodeId is invalid, the method will return {0, 0}, and an error will be logged.
+     */
+    Point getNodePosition(NodeId nodeId) const override;
+
+    /**
+     * @brief The grid width.
+     */
+    int getGridStride() const override { return width_; }
+
+    /**
+     * @brief Number of tiles currently held in memory.
+     */
+    std::size_t getResidentTileCount() const;
+
+    /**
+     * @brief Number of tiles read from disk so far (demand loads and prefetches).
+     */
+    std::size_t getTileLoadCount() const;
+};
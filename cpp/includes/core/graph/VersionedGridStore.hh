@@ -0,0 +1,200 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "graph/IGraph.hh"
+#include "types/Structs.hh"
+
+/**
+ * @brief Grid whose walls change while searches run, each search on a consistent snapshot.
+ *
+ * The map is split into square tiles, like PagedGridGraph's. A version is an array of pointers to
+ * immutable tiles. apply() copies only the tiles its edits touch, shares the others with the
+ * previous version, and publishes the result as the new current version with one atomic store.
+ * snapshot() pins whichever version is current; the snapshot then reads it without any lock, and
+ * later edits do not change what it sees.
+ *
+ * Old versions are reclaimed with epoch-based reclamation. A snapshot announces the global epoch
+ * in a reader slot before it loads the current version. A replaced version is tagged with the
+ * epoch at which it was retired, and freed once every announced epoch is newer. Readers only
+ * claim and release a slot; writers are serialized by a mutex and do all the freeing.
+ *
+ * Node ids, positions and edge costs follow GridGraph with every cell costing 1, so every
+ * IAlgorithm runs on a snapshot unchanged.
+ */
+class VersionedGridStore {
+
+  private:
+    struct Tile {
+      std::vector<uint8_t> cells;  // tileSize * tileSize, 0 = walkable
+    };
+
+    struct Version {
+      uint64_t number;
+      std::vector<std::shared_ptr<const Tile>> tiles;  // shared with the versions around it
+      std::vector<const uint8_t*> cells;               // tiles[t]->cells.data(), for readers
+    };
+
+    // One per concurrent snapshot, never freed before the store. epoch is kIdle while unclaimed.
+    struct ReaderSlot {
+      std::atomic<uint64_t> epoch;
+      ReaderSlot* next;
+    };
+
+    static constexpr uint64_t kIdle = std::numeric_limits<uint64_t>::max();
+
+    int width_;
+    int height_;
+    int tileShift_;
+    int tilesX_;
+    int tilesY_;
+
+    std::atomic<const Version*> current_;
+    std::atomic<uint64_t> currentNumber_{0};  // current_->number, readable without pinning it
+    std::atomic<uint64_t> epoch_{0};
+    mutable std::atomic<ReaderSlot*> readers_{nullptr};
+
+    mutable std::mutex writeMutex_;
+    std::vector<std::pair<uint64_t, const Version*>> retired_;  // (retire epoch, version), under writeMutex_
+
+    ReaderSlot* claimSlot() const;
+    void reclaim();
+
+  public:
+    /**
+     * @brief A cell edit for apply().
+     */
+    struct CellEdit {
+      NodeId cell;
+      bool blocked;
+    };
+
+    /**
+     * @brief One version of the grid, pinned until the snapshot is destroyed.
+     *
+     * Reads never lock and never see a later edit. Release snapshots before the store is
+     * destroyed; a snapshot that lives on keeps every version from its own onwards in memory.
+     */
+    class Snapshot : public IGraph {
+      friend class VersionedGridStore;
+
+      private:
+        const VersionedGridStore& store_;
+        ReaderSlot* slot_;
+        const Version* version_;
+
+        Snapshot(const VersionedGridStore& store, ReaderSlot* slot, const Version* version)
+            : store_(store), slot_(slot), version_(version) {}
+
+        bool walkableAt(int x, int y) const {
+          if (x < 0 || y < 0 || x >= store_.width_ || y >= store_.height_) return false;
+          const int shift = store_.tileShift_;
+          const int mask = (1 << shift) - 1;
+          const uint8_t* tile = version_->cells[static_cast<std::size_t>((y >> shift) * store_.tilesX_ + (x >> shift))];
+          return tile[((y & mask) << shift) + (x & mask)] == 0;
+        }
+
+      public:
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        /**
+         * @brief Release the version for reclamation.
+         */
+        ~Snapshot() override;
+
+        /**
+         * @brief The version number this snapshot reads.
+         */
+        uint64_t version() const { return version_->number; }
+
+        bool isWalkable(NodeId nodeId) const;
+
+        NodeCount getNodeCount() const override;
+
+        /**
+         * @brief The walkable 8-neighbours, in GridGraph's order and at its costs.
+         *
+         * @note If the nodeId is invalid, the out vector will remain empty, and an error will be logged.
+         */
+        void getNeighbors(NodeId id, std::vector<Edge>& out) const override;
+
+        /**
+         * @note If the nodeId is invalid, the method will return {0, 0}, and an error will be logged.
+         */
+        Point getNodePosition(NodeId nodeId) const override;
+
+        /**
+         * @brief Always true: every cell costs 1.
+         */
+        bool isUniformGrid() const override { return true; }
+
+        /**
+         * @brief The same supercover walk as GridGraph::lineOfSight.
+         */
+        bool lineOfSight(NodeId from, NodeId to) const override;
+
+        Cost getEdgeCost(NodeId from, NodeId to) const override;
+
+        /**
+         * @brief The grid width.
+         */
+        int getGridStride() const override { return store_.width_; }
+    };
+
+    /**
+     * @brief Version 0 of a row-major grid (0 = walkable, non-zero = blocked).
+     *
+     * @param tileSize Side of a tile in cells, a power of two: the unit an edit copies.
+     * @throws std::invalid_argument If the sizes are inconsistent or tileSize is not a power of two.
+     */
+    VersionedGridStore(int width, int height, const std::vector<uint8_t>& grid, int tileSize = 64);
+
+    /**
+     * @brief Free every version. No snapshot may still be alive.
+     */
+    ~VersionedGridStore();
+
+    VersionedGridStore(const VersionedGridStore&) = delete;
+    VersionedGridStore& operator=(const VersionedGridStore&) = delete;
+
+    /**
+     * @brief Pin the current version. Lock-free; safe from any thread, alongside apply().
+     */
+    std::shared_ptr<const Snapshot> snapshot() const;
+
+    /**
+     * @brief Apply a batch of edits as one new version and reclaim the versions no snapshot reads.
+     *
+     * Out-of-range cells are skipped with a warning. Edits that change nothing copy nothing; a
+     * batch that changes nothing publishes no version.
+     *
+     * @return The number of the current version afterwards.
+     */
+    uint64_t apply(const std::vector<CellEdit>& edits);
+
+    /**
+     * @brief Number of the current version.
+     */
+    uint64_t version() const { return currentNumber_.load(); }
+
+    /**
+     * @brief Replaced versions still waiting for a snapshot to be released.
+     */
+    std::size_t retiredCount() const;
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+};
@@ -23,13 +23,18 @@ class Chebyshev : public IHeuristic {
      */
     std::shared_ptr<const IGraph> graph_;
 
+    /**
+     * @brief The graph's minimum step cost, so distances are in cost units on weighted terrain.
+     */
+    Cost scale_;
+
   public:
     /**
      * @brief Constructor for the Chebyshev heuristic.
      * 
      * @param graph Reference to the graph on which the heuristic will operate.
      */
-    explicit Chebyshev( std::shared_ptr<const IGraph> graph ) : graph_(graph) {}
+    explicit Chebyshev( std::shared_ptr<const IGraph> graph ) : graph_(graph), scale_(graph ? graph->getMinStepCost() : 1.0) {}
 
     /**
      * @brief Compute the Chebyshev distance between two nodes.
@@ -42,4 +47,9 @@ class Chebyshev : public IHeuristic {
      * @note If node IDs are invalid, the method will return 0 and log an error.
      */
     Cost compute(NodeId from, NodeId to) const override;
+
+    /**
+     * @brief The Chebyshev distance from each of count nodes to the target, a SIMD register of nodes at a time.
+     */
+    void computeBatch(const NodeId* from, std::size_t count, NodeId to, Cost* out) const override;
 };
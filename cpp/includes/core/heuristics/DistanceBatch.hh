@@ -0,0 +1,43 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#include "graph/IGraph.hh"
+#include "simd/Simd.hh"
+
+/**
+ * @brief Shared body of the grid heuristics' computeBatch().
+ *
+ * Gathers |dx| and |dy| from every node to the target, then evaluates distance(dx, dy) on
+ * simd::Doubles, Doubles::kLanes nodes per call.
+ */
+template <typename Distance>
+void computeDistanceBatch(const IGraph& graph, const NodeId* from, std::size_t count, NodeId to, Cost* out,
+                          const Distance& distance) {
+  // A multiple of every backend's lane count; A* batches at most eight neighbours anyway.
+  constexpr std::size_t kChunk = 16;
+  const Point b = graph.getNodePosition(to);
+  int32_t dx[kChunk] = {};
+  int32_t dy[kChunk] = {};
+  Cost result[kChunk];
+
+  for (std::size_t begin = 0; begin < count; begin += kChunk) {
+    const std::size_t size = std::min(kChunk, count - begin);
+    for (std::size_t i = 0; i < size; ++i) {
+      const Point a = graph.getNodePosition(from[begin + i]);
+      dx[i] = std::abs(a.x - b.x);
+      dy[i] = std::abs(a.y - b.y);
+    }
+    for (std::size_t i = 0; i < size; i += simd::Doubles::kLanes) {
+      distance(simd::Doubles::fromInts(dx + i), simd::Doubles::fromInts(dy + i)).store(result + i);
+    }
+    std::copy(result, result + size, out + begin);
+  }
+}
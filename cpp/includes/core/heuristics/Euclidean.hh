@@ -23,6 +23,11 @@ class Euclidean : public IHeuristic {
      */
     std::shared_ptr<const IGraph> graph_;
 
+    /**
+     * @brief The graph's minimum step cost, so distances are in cost units on weighted terrain.
+     */
+    Cost scale_;
+
     
   public:
     /**
@@ -30,7 +35,7 @@ class Euclidean : public IHeuristic {
      * 
      * @param graph Reference to the graph on which the heuristic will operate.
      */
-    explicit Euclidean( std::shared_ptr<const IGraph> graph ) : graph_(graph) {}
+    explicit Euclidean( std::shared_ptr<const IGraph> graph ) : graph_(graph), scale_(graph ? graph->getMinStepCost() : 1.0) {}
 
     /**
      * @brief Compute the Euclidean distance between two nodes.
@@ -43,4 +48,9 @@ class Euclidean : public IHeuristic {
      * @note If node IDs are invalid, the method will return 0 and log an error.
      */
     Cost compute(NodeId from, NodeId to) const override;
+
+    /**
+     * @brief The Euclidean distance from each of count nodes to the target, a SIMD register of nodes at a time.
+     */
+    void computeBatch(const NodeId* from, std::size_t count, NodeId to, Cost* out) const override;
 };
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "types/Usings.hh"
 
 /**
@@ -26,6 +28,20 @@ public:
    */
   virtual Cost compute( NodeId from, NodeId to ) const = 0;
 
+  /**
+   * @brief Compute the estimated cost from each of several nodes to the same target.
+   *
+   * The grid heuristics evaluate the batch with SIMD; out[i] always equals compute(from[i], to).
+   *
+   * @param from The count NodeIds to estimate from.
+   * @param count The number of nodes.
+   * @param to The NodeId of the target node.
+   * @param out Receives the count estimates.
+   */
+  virtual void computeBatch( const NodeId* from, std::size_t count, NodeId to, Cost* out ) const {
+    for (std::size_t i = 0; i < count; ++i) out[i] = compute(from[i], to);
+  }
+
   /**
    * @brief Virtual destructor for proper cleanup of derived classes.
    */
@@ -0,0 +1,194 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Build with -DPATHFINDING_SIMD=0 to force the scalar fallback whatever the target supports.
+#ifndef PATHFINDING_SIMD
+#define PATHFINDING_SIMD 1
+#endif
+
+// The backend follows the target flags: -msimd128 under emcc, -mavx2 natively (SSE2 is the x86-64
+// baseline), anything else runs the scalar code.
+#if PATHFINDING_SIMD && defined(__wasm_simd128__)
+#define PATHFINDING_SIMD_WASM 1
+#include <wasm_simd128.h>
+#elif PATHFINDING_SIMD && defined(__AVX2__)
+#define PATHFINDING_SIMD_AVX2 1
+#include <immintrin.h>
+#elif PATHFINDING_SIMD && (defined(__SSE2__) || defined(_M_X64))
+#define PATHFINDING_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief A small portable layer over the vector instructions the hot kernels need.
+ *
+ * Two lane types cover them: Bytes (cell flags, 16 or 32 per register) and Doubles (costs, 1 to 4
+ * per register). Kernels are written once against these and loop in steps of kLanes; every
+ * operation has the same result on every backend, scalar fallback included, so searches return
+ * identical answers whichever one a build picked.
+ */
+namespace simd {
+
+#if defined(PATHFINDING_SIMD_WASM)
+constexpr const char* kBackend = "wasm-simd128";
+#elif defined(PATHFINDING_SIMD_AVX2)
+constexpr const char* kBackend = "avx2";
+#elif defined(PATHFINDING_SIMD_SSE2)
+constexpr const char* kBackend = "sse2";
+#else
+constexpr const char* kBackend = "scalar";
+#endif
+
+/**
+ * @brief kLanes unsigned bytes. bitmask() gathers their top bits, so flags are stored as 0x00 / 0xFF.
+ *
+ * The bitwise operations also serve as plain bit sets: andNot() keeps the bits o lacks, any()
+ * tells whether a bit is set.
+ */
+struct Bytes {
+#if defined(PATHFINDING_SIMD_WASM)
+  static constexpr std::size_t kLanes = 16;
+  v128_t v;
+
+  static Bytes load(const uint8_t* p) { return {wasm_v128_load(p)}; }
+  static Bytes splat(uint8_t b) { return {wasm_u8x16_splat(b)}; }
+  void store(uint8_t* p) const { wasm_v128_store(p, v); }
+  Bytes operator&(Bytes o) const { return {wasm_v128_and(v, o.v)}; }
+  Bytes operator|(Bytes o) const { return {wasm_v128_or(v, o.v)}; }
+  Bytes andNot(Bytes o) const { return {wasm_v128_andnot(v, o.v)}; }
+  bool any() const { return wasm_v128_any_true(v); }
+  uint32_t bitmask() const { return wasm_i8x16_bitmask(v); }
+#elif defined(PATHFINDING_SIMD_AVX2)
+  static constexpr std::size_t kLanes = 32;
+  __m256i v;
+
+  static Bytes load(const uint8_t* p) { return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))}; }
+  static Bytes splat(uint8_t b) { return {_mm256_set1_epi8(static_cast<char>(b))}; }
+  void store(uint8_t* p) const { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+  Bytes operator&(Bytes o) const { return {_mm256_and_si256(v, o.v)}; }
+  Bytes operator|(Bytes o) const { return {_mm256_or_si256(v, o.v)}; }
+  Bytes andNot(Bytes o) const { return {_mm256_andnot_si256(o.v, v)}; }
+  bool any() const { return !_mm256_testz_si256(v, v); }
+  uint32_t bitmask() const { return static_cast<uint32_t>(_mm256_movemask_epi8(v)); }
+#elif defined(PATHFINDING_SIMD_SSE2)
+  static constexpr std::size_t kLanes = 16;
+  __m128i v;
+
+  static Bytes load(const uint8_t* p) { return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))}; }
+  static Bytes splat(uint8_t b) { return {_mm_set1_epi8(static_cast<char>(b))}; }
+  void store(uint8_t* p) const { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+  Bytes operator&(Bytes o) const { return {_mm_and_si128(v, o.v)}; }
+  Bytes operator|(Bytes o) const { return {_mm_or_si128(v, o.v)}; }
+  Bytes andNot(Bytes o) const { return {_mm_andnot_si128(o.v, v)}; }
+  bool any() const { return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) != 0xFFFF; }
+  uint32_t bitmask() const { return static_cast<uint32_t>(_mm_movemask_epi8(v)); }
+#else
+  // Eight lanes in one word, so the fallback still works a word at a time.
+  static constexpr std::size_t kLanes = 8;
+  uint64_t v;
+
+  static Bytes load(const uint8_t* p) { Bytes b; std::memcpy(&b.v, p, sizeof b.v); return b; }
+  static Bytes splat(uint8_t b) { return {uint64_t{b} * 0x0101010101010101ull}; }
+  void store(uint8_t* p) const { std::memcpy(p, &v, sizeof v); }
+  Bytes operator&(Bytes o) const { return {v & o.v}; }
+  Bytes operator|(Bytes o) const { return {v | o.v}; }
+  Bytes andNot(Bytes o) const { return {v & ~o.v}; }
+  bool any() const { return v != 0; }
+  uint32_t bitmask() const {
+    // Top bit of byte i lands in bit 56 + i of the product, for little-endian lane order.
+    const uint64_t tops = (v >> 7) & 0x0101010101010101ull;
+    return static_cast<uint32_t>((tops * 0x0102040810204080ull) >> 56);
+  }
+#endif
+};
+
+/**
+ * @brief kLanes doubles, for costs and heuristic distances.
+ */
+struct Doubles {
+#if defined(PATHFINDING_SIMD_WASM)
+  static constexpr std::size_t kLanes = 2;
+  v128_t v;
+
+  static Doubles load(const double* p) { return {wasm_v128_load(p)}; }
+  static Doubles splat(double d) { return {wasm_f64x2_splat(d)}; }
+  // Converts the first kLanes ints.
+  static Doubles fromInts(const int32_t* p) { return {wasm_f64x2_convert_low_i32x4(wasm_v128_load64_zero(p))}; }
+  void store(double* p) const { wasm_v128_store(p, v); }
+  Doubles operator+(Doubles o) const { return {wasm_f64x2_add(v, o.v)}; }
+  Doubles operator*(Doubles o) const { return {wasm_f64x2_mul(v, o.v)}; }
+  friend Doubles min(Doubles a, Doubles b) { return {wasm_f64x2_pmin(a.v, b.v)}; }
+  friend Doubles max(Doubles a, Doubles b) { return {wasm_f64x2_pmax(a.v, b.v)}; }
+  friend Doubles sqrt(Doubles a) { return {wasm_f64x2_sqrt(a.v)}; }
+#elif defined(PATHFINDING_SIMD_AVX2)
+  static constexpr std::size_t kLanes = 4;
+  __m256d v;
+
+  static Doubles load(const double* p) { return {_mm256_loadu_pd(p)}; }
+  static Doubles splat(double d) { return {_mm256_set1_pd(d)}; }
+  static Doubles fromInts(const int32_t* p) { return {_mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)))}; }
+  void store(double* p) const { _mm256_storeu_pd(p, v); }
+  Doubles operator+(Doubles o) const { return {_mm256_add_pd(v, o.v)}; }
+  Doubles operator*(Doubles o) const { return {_mm256_mul_pd(v, o.v)}; }
+  friend Doubles min(Doubles a, Doubles b) { return {_mm256_min_pd(a.v, b.v)}; }
+  friend Doubles max(Doubles a, Doubles b) { return {_mm256_max_pd(a.v, b.v)}; }
+  friend Doubles sqrt(Doubles a) { return {_mm256_sqrt_pd(a.v)}; }
+#elif defined(PATHFINDING_SIMD_SSE2)
+  static constexpr std::size_t kLanes = 2;
+  __m128d v;
+
+  static Doubles load(const double* p) { return {_mm_loadu_pd(p)}; }
+  static Doubles splat(double d) { return {_mm_set1_pd(d)}; }
+  static Doubles fromInts(const int32_t* p) { return {_mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)))}; }
+  void store(double* p) const { _mm_storeu_pd(p, v); }
+  Doubles operator+(Doubles o) const { return {_mm_add_pd(v, o.v)}; }
+  Doubles operator*(Doubles o) const { return {_mm_mul_pd(v, o.v)}; }
+  friend Doubles min(Doubles a, Doubles b) { return {_mm_min_pd(a.v, b.v)}; }
+  friend Doubles max(Doubles a, Doubles b) { return {_mm_max_pd(a.v, b.v)}; }
+  friend Doubles sqrt(Doubles a) { return {_mm_sqrt_pd(a.v)}; }
+#else
+  static constexpr std::size_t kLanes = 1;
+  double v;
+
+  static Doubles load(const double* p) { return {*p}; }
+  static Doubles splat(double d) { return {d}; }
+  static Doubles fromInts(const int32_t* p) { return {static_cast<double>(*p)}; }
+  void store(double* p) const { *p = v; }
+  Doubles operator+(Doubles o) const { return {v + o.v}; }
+  Doubles operator*(Doubles o) const { return {v * o.v}; }
+  friend Doubles min(Doubles a, Doubles b) { return {a.v < b.v ? a.v : b.v}; }
+  friend Doubles max(Doubles a, Doubles b) { return {a.v > b.v ? a.v : b.v}; }
+  friend Doubles sqrt(Doubles a) { return {std::sqrt(a.v)}; }
+#endif
+};
+
+/**
+ * @brief Pack count flag bytes (0x00 / 0xFF) into bits, bit i % 64 of words[i / 64].
+ *
+ * The words covering [0, count) are overwritten; bits past count are cleared.
+ */
+inline void packFlags(const uint8_t* flags, std::size_t count, uint64_t* words) {
+  std::size_t i = 0;
+  for (; i + 64 <= count; i += 64) {
+    uint64_t word = 0;
+    for (std::size_t lane = 0; lane < 64; lane += Bytes::kLanes) {
+      word |= uint64_t{Bytes::load(flags + i + lane).bitmask()} << lane;
+    }
+    words[i / 64] = word;
+  }
+  if (i == count) return;
+  uint64_t word = 0;
+  for (std::size_t j = i; j < count; ++j) word |= static_cast<uint64_t>(flags[j] >> 7) << (j - i);
+  words[i / 64] = word;
+}
+
+} // namespace simd
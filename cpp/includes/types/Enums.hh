@@ -20,7 +20,11 @@ enum class AlgorithmType {
   DFS,
   JUMPPOINT,
   ORTHOGONALJUMPPOINT,
-  TRACE
+  TRACE,
+  ARASTAR,
+  FOCAL,
+  THETASTAR,
+  LAZYTHETASTAR
 };
 
 /**
@@ -36,4 +40,78 @@ enum class HeuristicType {
   EUCLIDEAN,
   OCTILE,
   CHEBYSHEV
-};
\ No newline at end of file
+};
+
+/**
+ * @enum SearchStatus
+ * @brief Why a search returned.
+ *
+ * Searches stopped by a budget or a cancellation return a partial Result
+ * (success = false) whose path leads to the expanded node closest to the goal.
+ */
+enum class SearchStatus {
+  SUCCESS,
+  NO_PATH,
+  INVALID_INPUT,
+  TIMEOUT,
+  EXPANSION_LIMIT,
+  CANCELLED
+};
+
+/**
+ * @enum VisitedRecording
+ * @brief How an algorithm records the nodes it expands.
+ *
+ * Recording the full expansion order is only needed for visualization; the
+ * other modes bound or remove its memory cost.
+ */
+enum class VisitedRecording {
+  OFF,      // nothing is recorded
+  FULL,     // every expanded node, in order, in Result::visited
+  SAMPLED,  // every Nth expanded node, in order, in Result::visited
+  BITMAP,   // one bit per node in Result::visitedBitmap (order is lost)
+  DELTAS,   // expansion order as id deltas, one varint per node, in Result::visitedDeltas
+  STREAM    // every expanded node, in order, handed to a VisitSink in chunks while the search runs
+};
+
+/**
+ * @enum TieBreaking
+ * @brief How A* orders open nodes with equal f.
+ *
+ * On uniform-cost grids whole plateaus of nodes share the same f; preferring the ones that are
+ * already deep in the search reaches the goal before the rest of the plateau is expanded. Only the
+ * order among equal-f nodes changes, so an optimal search stays optimal.
+ */
+enum class TieBreaking {
+  NONE,           // heap order, as before
+  HIGH_G,         // larger g first (closer to the goal for the same f)
+  CROSS_PRODUCT,  // smaller deviation from the straight start-goal line first, then larger g
+  LIFO            // most recently pushed first
+};
+
+/**
+ * @enum PathSmoothing
+ * @brief Post-processing the engine applies to a found path.
+ *
+ * Grid paths zigzag; agents follow far fewer points when the path is reduced to waypoints joined
+ * by straight, obstacle-free segments.
+ */
+enum class PathSmoothing {
+  NONE,         // Result::waypoints stays empty
+  WAYPOINTS,    // the path's turning points: same route, same cost
+  STRING_PULL   // line-of-sight shortcuts between path cells (uniform-cost grids; else WAYPOINTS)
+};
+
+/**
+ * @enum CostPrecision
+ * @brief Number type A* and Dijkstra keep their g and f scores in.
+ *
+ * The narrower types halve the score arrays and open-list entries. Result::cost is still summed
+ * exactly along the returned path; only the choice between paths whose costs differ by less than
+ * the precision can change.
+ */
+enum class CostPrecision {
+  DOUBLE,  // 64-bit floating point, exact
+  FLOAT,   // 32-bit floating point
+  FIXED    // 32-bit fixed point, 1/1024 of a unit step
+};
@@ -5,9 +5,14 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
 #include <vector>
 
 #include "types/Usings.hh"
+#include "types/Enums.hh"
 
 /**
  * @brief Structure representing a weighted edge to a neighboring node.
@@ -20,21 +25,100 @@ struct Edge {
   Cost cost;
 };
 
+/**
+ * @brief Receives expanded nodes while a search runs (VisitedRecording::STREAM).
+ *
+ * Called with up to the configured chunk size of NodeIds at a time, in expansion order, and once
+ * more with the remainder before the search returns. It runs on the searching thread and must not
+ * throw; ids only lives for the duration of the call.
+ */
+using VisitSink = std::function<void(const NodeId* ids, std::size_t count)>;
+
+/**
+ * @brief Counters and phase timings collected while a search runs.
+ *
+ * Filled by StatsRecorder; every field stays zero when the library is built with
+ * PATHFINDING_STATS=0.
+ *
+ * @param expansions Nodes taken off the open list and expanded (IDA* counts every re-expansion).
+ * @param generated Successors produced after the movement rules were applied.
+ * @param pushes Insertions into the open list.
+ * @param pops Removals from the open list, stale ones included.
+ * @param stalePops Removals discarded because a cheaper entry for the node had been pushed since.
+ * @param peakOpen Largest size the open list (or DFS stack) reached.
+ * @param heuristicCalls Calls to IHeuristic::compute.
+ * @param workspaceBytes Memory held by the search's per-node arrays and open list at its peak.
+ * @param setupTime Time spent validating input and allocating per-node state.
+ * @param graphBuildTime Time spent building the graph (set by the engine; 0 when the caller owns it).
+ * @param searchTime Time spent in the main search loop.
+ * @param reconstructTime Time spent walking parents back into a path and summing its cost.
+ * @param smoothingTime Time spent turning the path into waypoints (set by the engine).
+ */
+struct SearchStats {
+  uint64_t expansions = 0;
+  uint64_t generated = 0;
+  uint64_t pushes = 0;
+  uint64_t pops = 0;
+  uint64_t stalePops = 0;
+  uint64_t peakOpen = 0;
+  uint64_t heuristicCalls = 0;
+  uint64_t workspaceBytes = 0;
+  Time setupTime = Time::zero();
+  Time graphBuildTime = Time::zero();
+  Time searchTime = Time::zero();
+  Time reconstructTime = Time::zero();
+  Time smoothingTime = Time::zero();
+};
+
 /**
  * @brief Result structure to hold the outcome of pathfinding algorithms.
  * 
  * @param path The sequence of NodeIds representing the found path (In order).
- * @param visited The sequence of NodeIds that were visited during the search (In order).
+ * @param visited The sequence of NodeIds that were visited during the search (In order), or a
+ * sample of it, depending on the VisitedRecording mode.
+ * @param visitedBitmap One bit per node (bit i % 32 of word i / 32) set when the node was visited.
+ * Only filled in VisitedRecording::BITMAP mode.
+ * @param visitedDeltas The visit order as one zig-zag varint per expansion, see
+ * VisitRecorder::decodeDeltas. Only filled in VisitedRecording::DELTAS mode.
  * @param cost The total cost of the found path.
  * @param time The time taken to compute the path.
  * @param success A boolean indicating whether a path was successfully found.
+ * @param suboptimalityBound Proven bound on cost / optimal cost (1 for optimal searches).
+ * @param status Why the search returned. On TIMEOUT, EXPANSION_LIMIT and CANCELLED the path (and
+ * cost) lead from start to the expanded node closest to the goal.
+ * @param cacheHit True when the route was served by a RouteCache instead of a search.
+ * @param stats Search counters and per-phase timings.
+ * @param waypoints The path reduced to the points an agent has to steer towards (first and last
+ * included), when path smoothing was requested; consecutive waypoints see each other.
+ * @param waypointCost Length of the waypoint polyline, in the same units as cost.
+ * @param chainStart First node of the chain code.
+ * @param chainCode The path as one Freeman code (0 to 7) per step from chainStart, when requested
+ * and every step joins two 8-neighbours; see ChainCode.
+ *
+ * The arrays allocate from the memory resource given at construction (the global heap by
+ * default), so a caller can have results written into buffers it owns.
  */
 struct Result {
-  std::vector<NodeId> path;
-  std::vector<NodeId> visited;
+  Result() = default;
+  explicit Result(std::pmr::memory_resource* memory)
+      : path(memory), visited(memory), visitedBitmap(memory), visitedDeltas(memory), waypoints(memory),
+        chainCode(memory) {}
+
+  std::pmr::vector<NodeId> path;
+  std::pmr::vector<NodeId> visited;
+  std::pmr::vector<uint32_t> visitedBitmap;
+  std::pmr::vector<uint8_t> visitedDeltas;
   Cost cost;
   Time time;
   bool success;
+  Cost suboptimalityBound = 1.0;
+  SearchStatus status = SearchStatus::INVALID_INPUT;
+  bool cacheHit = false;
+  SearchStats stats;
+  std::pmr::vector<NodeId> waypoints;
+  Cost waypointCost = 0.0;
+  NodeId chainStart = 0;
+  std::pmr::vector<uint8_t> chainCode;
 };
 
 /**
@@ -0,0 +1,78 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+
+namespace utils {
+
+/**
+ * @brief Per-thread bump allocator for the temporaries of one query.
+ *
+ * A Scope hands out a monotonic resource over a block owned by the calling thread: allocations are
+ * pointer bumps, nothing is freed until the scope ends, and then everything goes at once. The
+ * block grows to the largest query the thread has run (up to kMaxRetainedBytes), so a thread
+ * answering similar queries stops calling the global allocator after its first one. Threads never
+ * share a block, so concurrent queries do not contend on the heap.
+ *
+ * A query started on a thread whose block is already in use (say from a VisitSink) gets a
+ * resource of its own instead.
+ */
+class QueryArena {
+
+  private:
+    struct Block;
+    static Block& threadBlock();
+
+  public:
+    // Largest block a thread keeps between queries; bigger queries take the rest from the heap.
+    static constexpr std::size_t kMaxRetainedBytes = std::size_t{64} << 20;
+
+    class Scope {
+
+      private:
+        // Forwards to the global heap, counting what the block could not hold.
+        class Overflow : public std::pmr::memory_resource {
+          public:
+            std::size_t bytes = 0;
+
+          private:
+            void* do_allocate(std::size_t size, std::size_t alignment) override;
+            void do_deallocate(void* p, std::size_t size, std::size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+        };
+
+        Block* block_;
+        Overflow overflow_;
+        std::optional<std::pmr::monotonic_buffer_resource> arena_;
+
+      public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /**
+         * @brief The resource to allocate the query's temporaries from. Valid until the scope ends.
+         */
+        std::pmr::memory_resource* resource() { return &*arena_; }
+    };
+
+    /**
+     * @brief Bytes the calling thread's block holds between queries.
+     */
+    static std::size_t retainedBytes();
+
+    /**
+     * @brief Free the calling thread's block (it is rebuilt by the next query).
+     */
+    static void trim();
+};
+
+} // namespace utils
@@ -0,0 +1,89 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+// Size of the prespawned worker pool of a pthread WASM build (the Makefile passes WASM_THREADS);
+// 0 natively, where threads are started on demand.
+#ifndef PATHFINDING_THREAD_POOL
+#define PATHFINDING_THREAD_POOL 0
+#endif
+
+namespace utils {
+
+/**
+ * @brief How many threads a fan-out may run on, the calling thread included.
+ *
+ * maxThreads, or one per core when it is 0. A pthread WASM build caps it at its pool size plus the
+ * caller: a thread started once the pool is empty waits for the main thread to spawn a worker,
+ * which never happens while the main thread blocks in join(). On a thread inside a WorkerScope it
+ * is 1, so a fan-out started from another one's work runs inline.
+ */
+unsigned threadBudget(unsigned maxThreads);
+
+/**
+ * @brief Marks the calling thread as doing a fan-out's work for the scope's lifetime.
+ *
+ * Declared at the top of every fan-out's work function, on the workers and on the caller alike.
+ */
+class WorkerScope {
+
+  private:
+    bool previous_;
+
+  public:
+    WorkerScope();
+    ~WorkerScope();
+
+    WorkerScope(const WorkerScope&) = delete;
+    WorkerScope& operator=(const WorkerScope&) = delete;
+};
+
+/**
+ * @brief Run work on the calling thread and on up to threads - 1 new ones, then join them.
+ *
+ * A thread that cannot be started (e.g. a WASM build without pthreads) is skipped: work must
+ * finish whatever the others leave.
+ *
+ * @return The number of threads that ran work, the caller included.
+ */
+unsigned runOnThreads(unsigned threads, const std::function<void()>& work);
+
+/**
+ * @brief Call fn(i, state) for every i in [0, count) on up to threadBudget(maxThreads) threads.
+ *
+ * Indices are handed out one at a time, so uneven items balance across threads. Each thread calls
+ * makeState() once, inside a WorkerScope, and passes the state to every index it takes; that is
+ * where a search workspace goes, to be allocated once per thread rather than per item. fn may only
+ * write what index i owns.
+ *
+ * @return The number of threads that ran, the caller included (0 when count is 0).
+ */
+template <typename MakeState, typename Fn>
+unsigned parallelFor(std::size_t count, unsigned maxThreads, const MakeState& makeState, const Fn& fn) {
+  if (count == 0) return 0;
+  const unsigned threads = static_cast<unsigned>(std::min<std::size_t>(threadBudget(maxThreads), count));
+  std::atomic<std::size_t> next{0};
+  return runOnThreads(threads, [&]() {
+    WorkerScope worker;
+    auto state = makeState();
+    for (std::size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) fn(i, state);
+  });
+}
+
+/**
+ * @brief Call fn(i) for every i in [0, count), as above, with no per-thread state.
+ */
+template <typename Fn>
+unsigned parallelFor(std::size_t count, unsigned maxThreads, const Fn& fn) {
+  return parallelFor(count, maxThreads, [] { return 0; }, [&fn](std::size_t i, int) { fn(i); });
+}
+
+} // namespace utils
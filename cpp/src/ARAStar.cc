@@ -0,0 +1,265 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "algorithms/ARAStar.hh"
+#include "algorithms/VisitRecorder.hh"
+#include "algorithms/SearchBudget.hh"
+#include "algorithms/StatsRecorder.hh"
+#include "utils/Logger.hh"
+
+namespace {
+
+bool isDiagonalMove(const IGraph& graph, NodeId u, NodeId v) {
+  Point pu = graph.getNodePosition(u);
+  Point pv = graph.getNodePosition(v);
+  int dx = std::abs(pu.x - pv.x);
+  int dy = std::abs(pu.y - pv.y);
+  return dx == 1 && dy == 1;
+}
+
+bool violatesCornerRule(const IGraph& graph, NodeId u, NodeId v, const std::vector<Edge>& neighbors) {
+  Point pu = graph.getNodePosition(u);
+  Point pv = graph.getNodePosition(v);
+
+  int dx = std::abs(pu.x - pv.x);
+  int dy = std::abs(pu.y - pv.y);
+  if (dx != 1 || dy != 1) return false;
+
+  Point p1{pv.x, pu.y};
+  Point p2{pu.x, pv.y};
+
+  bool hasP1 = false;
+  bool hasP2 = false;
+
+  for (const Edge& e : neighbors) {
+    Point pn = graph.getNodePosition(e.id);
+    if (pn.x == p1.x && pn.y == p1.y) hasP1 = true;
+    if (pn.x == p2.x && pn.y == p2.y) hasP2 = true;
+  }
+
+  return !(hasP1 && hasP2);
+}
+
+struct OpenEntry {
+  Cost f;
+  Cost g;
+  NodeId id;
+  bool operator>(const OpenEntry& o) const { return f > o.f; }
+};
+
+// CLOSED nodes whose g improved after expansion wait in INCONS until the next pass.
+enum NodeState : uint8_t { NONE, OPEN, CLOSED, INCONS };
+
+} // namespace
+
+Result ARAStar::findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) {
+  Result res(config.resultMemory); res.success = false; res.cost = 0.0; res.time = Time::zero();
+  const auto t0 = std::chrono::steady_clock::now();
+  StatsRecorder stats(res);
+
+  LOG_INFO(std::string("ARA*: start from=") + std::to_string(start) + " to=" + std::to_string(goal));
+
+  if (!config.heuristic) {
+    LOG_ERROR("ARA*: no heuristic provided in config");
+    return res;
+  }
+  const IHeuristic& h = *config.heuristic;
+
+  NodeCount n = graph.getNodeCount();
+  if (start >= n || goal >= n) {
+    LOG_ERROR("ARA*: invalid start/goal");
+    return res;
+  }
+
+  const Cost INF = std::numeric_limits<Cost>::infinity();
+  const Cost step = config.weightStep > 0.0 ? config.weightStep : 0.5;
+  Cost eps = std::max<Cost>(1.0, config.weight);
+
+  std::vector<Cost> gScore(n, INF);
+  std::vector<NodeId> parent(n, static_cast<NodeId>(-1));
+  std::vector<NodeState> state(n, NONE);
+  std::vector<OpenEntry> open;
+  std::vector<NodeId> incons;
+  std::vector<NodeId> closed;
+  std::vector<Edge> neighbors;
+  VisitRecorder recorder(res, config, n);
+  SearchBudget budget(config, start, goal);
+
+  const auto push = [&](NodeId v) {
+    open.push_back({gScore[v] + eps * h.compute(v, goal), gScore[v], v});
+    std::push_heap(open.begin(), open.end(), std::greater<OpenEntry>());
+    stats.heuristicCall();
+    stats.pushed(open.size());
+  };
+
+  // One weighted A* pass reusing everything earlier passes learned. Returns false if the budget
+  // (deadline, expansion limit or cancellation) interrupted it.
+  const auto improvePath = [&]() {
+    while (!open.empty()) {
+      const OpenEntry top = open.front();
+      if (state[top.id] != OPEN || top.g != gScore[top.id]) {
+        std::pop_heap(open.begin(), open.end(), std::greater<OpenEntry>());
+        open.pop_back();
+        stats.popped();
+        stats.stalePop();
+        continue;
+      }
+      if (gScore[goal] <= top.f) return true;
+      if (budget.exhausted(top.id)) return false;
+
+      std::pop_heap(open.begin(), open.end(), std::greater<OpenEntry>());
+      open.pop_back();
+      stats.popped();
+      NodeId u = top.id;
+      state[u] = CLOSED;
+      closed.push_back(u);
+      recorder.record(u);
+      stats.expanded();
+
+      graph.getNeighbors(u, neighbors);
+      for (const Edge& e : neighbors) {
+        if (!config.allowDiagonal && isDiagonalMove(graph, u, e.id)) {
+          continue;
+        }
+        if (config.allowDiagonal && config.dontCrossCorners && isDiagonalMove(graph, u, e.id) &&
+            violatesCornerRule(graph, u, e.id, neighbors)) {
+          continue;
+        }
+        stats.generated();
+        Cost tentative_g = gScore[u] + e.cost;
+        if (tentative_g < gScore[e.id]) {
+          gScore[e.id] = tentative_g;
+          parent[e.id] = u;
+          if (state[e.id] == CLOSED) {
+            state[e.id] = INCONS;
+            incons.push_back(e.id);
+          } else if (state[e.id] != INCONS) {
+            state[e.id] = OPEN;
+            push(e.id);
+          }
+        }
+      }
+    }
+    return true;
+  };
+
+  // cost / min(g + h) over OPEN and INCONS bounds how far the current solution is from optimal.
+  const auto provenBound = [&]() {
+    Cost lower = INF;
+    for (const OpenEntry& e : open) {
+      if (state[e.id] == OPEN && e.g == gScore[e.id]) {
+        lower = std::min(lower, e.g + h.compute(e.id, goal));
+        stats.heuristicCall();
+      }
+    }
+    for (NodeId v : incons) {
+      if (state[v] == INCONS) {
+        lower = std::min(lower, gScore[v] + h.compute(v, goal));
+        stats.heuristicCall();
+      }
+    }
+    if (lower == INF || lower <= 0.0) return lower == INF ? 1.0 : eps;
+    return std::max<Cost>(1.0, std::min(eps, gScore[goal] / lower));
+  };
+
+  const auto publish = [&]() {
+    res.path.clear();
+    for (NodeId cur = goal; cur != static_cast<NodeId>(-1) && res.path.size() <= n; cur = parent[cur]) {
+      res.path.push_back(cur);
+      if (cur == start) break;
+    }
+    std::reverse(res.path.begin(), res.path.end());
+    res.cost = gScore[goal];
+    res.suboptimalityBound = provenBound();
+    res.success = true;
+    LOG_DEBUG(std::string("ARA*: solution cost=") + std::to_string(res.cost) + " bound=" + std::to_string(res.suboptimalityBound));
+  };
+
+  // Every pass reuses the same arrays; the open list is counted at its peak.
+  const auto recordWorkspace = [&]() {
+    stats.workspace(StatsRecorder::bytes(gScore) + StatsRecorder::bytes(parent) + StatsRecorder::bytes(state) +
+                    StatsRecorder::bytes(incons) + StatsRecorder::bytes(closed) + StatsRecorder::bytes(neighbors) +
+                    res.stats.peakOpen * sizeof(OpenEntry));
+  };
+
+  gScore[start] = 0.0;
+  state[start] = OPEN;
+  push(start);
+  stats.endSetup();
+
+  // If the budget runs out before the first solution, return the path to the closest node instead.
+  const bool firstPass = improvePath();
+  stats.endSearch();
+  recorder.flush();
+  if (!firstPass) {
+    recordWorkspace();
+    const NodeId target = budget.closest();
+    for (NodeId cur = target; cur != static_cast<NodeId>(-1) && res.path.size() <= n; cur = parent[cur]) {
+      res.path.push_back(cur);
+      if (cur == start) break;
+    }
+    std::reverse(res.path.begin(), res.path.end());
+    stats.endReconstruct();
+    res.cost = gScore[target];
+    res.status = budget.status();
+    res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+    LOG_WARN(std::string("ARA*: stopped, partial cost=") + std::to_string(res.cost));
+    return res;
+  }
+  if (gScore[goal] == INF) {
+    recordWorkspace();
+    res.status = SearchStatus::NO_PATH;
+    res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+    LOG_WARN("ARA*: no path found");
+    return res;
+  }
+  publish();
+  stats.endReconstruct();
+  res.status = SearchStatus::SUCCESS;
+
+  // Later passes only tighten the bound, so running out of budget keeps the last solution.
+  while (res.suboptimalityBound > 1.0 && std::chrono::steady_clock::now() < config.deadline) {
+    eps = std::max<Cost>(1.0, eps - step);
+
+    // OPEN = OPEN u INCONS with keys for the new weight; CLOSED starts empty again.
+    std::vector<OpenEntry> previous;
+    previous.swap(open);
+    for (const OpenEntry& e : previous) {
+      if (state[e.id] == OPEN && e.g == gScore[e.id]) push(e.id);
+    }
+    for (NodeId v : incons) {
+      if (state[v] == INCONS) {
+        state[v] = OPEN;
+        push(v);
+      }
+    }
+    incons.clear();
+    for (NodeId v : closed) {
+      if (state[v] == CLOSED) state[v] = NONE;
+    }
+    closed.clear();
+
+    const bool improved = improvePath();
+    stats.endSearch();
+    recorder.flush();
+    if (!improved) break;
+    publish();
+    stats.endReconstruct();
+  }
+  recordWorkspace();
+
+  res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+  LOG_INFO(std::string("ARA*: success cost=") + std::to_string(res.cost) + " bound=" + std::to_string(res.suboptimalityBound));
+  return res;
+}
@@ -9,95 +9,417 @@
 #include <limits>
 #include <memory>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <memory_resource>
 
 #include "algorithms/AStar.hh"
+#include "algorithms/AStarSearch.hh"
+#include "algorithms/ParentMap.hh"
+#include "algorithms/ScoreTraits.hh"
+#include "algorithms/VisitRecorder.hh"
+#include "algorithms/SearchBudget.hh"
+#include "algorithms/StatsRecorder.hh"
 #include <string>
 #include "utils/Logger.hh"
 
+namespace {
+
+// Open-list entry; S is the score type chosen by CostPrecision.
+template <typename S>
 struct AStarNode {
-  Cost f;
-  Cost g;
+  S f;
+  S tie;
+  S g;
   NodeId id;
-  bool operator>(const AStarNode& o) const { return f > o.f; }
+  uint64_t rank;
+  // Equal f falls back to the tie-breaking key (smaller first), then to rank (larger first).
+  bool operator>(const AStarNode& o) const {
+    if (f != o.f) return f > o.f;
+    if (tie != o.tie) return tie > o.tie;
+    return rank < o.rank;
+  }
 };
 
-Result AStar::findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) {
-  Result res; res.success = false; res.cost = 0.0; res.time = Time::zero();
-  const auto t0 = std::chrono::steady_clock::now();
+// With a tie-breaking policy, f is rounded to this resolution so that sums of 1 and sqrt(2) that
+// are equal on paper also compare equal.
+constexpr Cost kTieResolution = 1.0 / (1 << 20);
 
-  LOG_INFO(std::string("AStar: start from=") + std::to_string(start) + " to=" + std::to_string(goal));
+// g values this close (relative) are the same path length reached in a different move order.
+constexpr Cost kSameCost = 1e-9;
 
-  if (!config.heuristic) {
-    LOG_ERROR("AStar: no heuristic provided in config");
-    res.time = Time::zero();
-    return res;
-  }
-  const IHeuristic& h = *config.heuristic;
+// Moves are numbered (dy + 1) * 3 + (dx + 1); the centre, kNoMove, marks the start node.
+constexpr int kNoMove = 4;
+constexpr uint16_t kAllMoves = 0x1FF;
 
-  NodeCount n = graph.getNodeCount();
-  if (start >= n || goal >= n) {
-    LOG_ERROR("AStar: invalid start/goal");
-    res.time = Time::zero();
-    return res;
+uint16_t moveBit(int dx, int dy) {
+  return static_cast<uint16_t>(1u << ((dy + 1) * 3 + (dx + 1)));
+}
+
+// Moves a canonical (diagonal-first) path may continue with after arriving by move m: straight on,
+// a diagonal also continues along its two components, and a wall beside the node forces the
+// diagonal around it. walkable holds the moves to walkable neighbours.
+uint16_t canonicalSuccessors(int m, uint16_t walkable) {
+  if (m == kNoMove) return kAllMoves;
+  const int dx = m % 3 - 1;
+  const int dy = m / 3 - 1;
+  const auto blocked = [&](int x, int y) { return (walkable & moveBit(x, y)) == 0; };
+
+  uint16_t out = moveBit(dx, dy);
+  if (dx != 0 && dy != 0) {
+    out = static_cast<uint16_t>(out | moveBit(dx, 0) | moveBit(0, dy));
+    if (blocked(-dx, 0)) out |= moveBit(-dx, dy);
+    if (blocked(0, -dy)) out |= moveBit(dx, -dy);
+  } else if (dx != 0) {
+    if (blocked(0, 1)) out |= moveBit(dx, 1);
+    if (blocked(0, -1)) out |= moveBit(dx, -1);
+  } else {
+    if (blocked(1, 0)) out |= moveBit(1, dy);
+    if (blocked(-1, 0)) out |= moveBit(-1, dy);
   }
+  return out;
+}
+
+
+// Read the clock once every this many expansions within a slice.
+constexpr std::size_t kClockInterval = 32;
+
+// S is the score type chosen by CostPrecision.
+template <typename S>
+class Search final : public AStarSearch {
+
+  private:
+    using Score = ScoreTraits<S>;
+    using PQ = std::priority_queue<AStarNode<S>, std::pmr::vector<AStarNode<S>>, std::greater<AStarNode<S>>>;
+
+    const IGraph& graph_;
+    const AlgorithmConfig config_;
+    const NodeId start_;
+    const NodeId goal_;
+    const bool informed_;
+    // Weighted A*: inflating h trades optimality (cost <= w * optimal) for fewer expansions.
+    const Cost w_;
+
+    Result res_;
+    StatsRecorder stats_;
+    const bool valid_;
+    const S INF = Score::infinity();
+
+    // Every per-node array and the open list come from config.memory, the engine's per-thread arena.
+    std::pmr::vector<S> gScore_;
+    std::pmr::vector<S> fScore_;
+    ParentMap parent_;
+    PQ open_;
+
+    TieBreaking tieBreaking_ = TieBreaking::NONE;
+    Point startPos_{0, 0};
+    Point goalPos_{0, 0};
+    uint64_t pushCount_ = 0;
+
+    // Canonical ordering: arrivals_[v] holds every move that reached v with its best g, and a node
+    // is expanded with the union of their canonical successors. A move arriving with an equal g
+    // after v was expanded re-opens it, so pruning never loses an optimal path.
+    const bool canonical_;
+    std::pmr::vector<uint16_t> arrivals_;
+    std::pmr::vector<uint16_t> expandedWith_;
 
-  const Cost INF = std::numeric_limits<Cost>::infinity();
-  std::vector<Cost> gScore(n, INF);
-  std::vector<Cost> fScore(n, INF);
-  std::vector<NodeId> parent(n, static_cast<NodeId>(-1));
-
-  using PQ = std::priority_queue<AStarNode, std::vector<AStarNode>, std::greater<AStarNode>>;
-  PQ open;
-
-  gScore[start] = 0.0;
-  fScore[start] = h.compute(start, goal);
-  open.push({fScore[start], gScore[start], start});
-
-  std::vector<Edge> neighbors;
-
-  while (!open.empty()) {
-    auto cur = open.top(); open.pop();
-    NodeId u = cur.id;
-    res.visited.push_back(u);
-    if (u == goal) break;
-    if (cur.g != gScore[u]) continue;
-    graph.getNeighbors(u, neighbors);
-    for (const Edge& e : neighbors) {
-      // option to ignore diagonals if config disallows them
-      if (!config.allowDiagonal) {
-        Point pu = graph.getNodePosition(u);
-        Point pv = graph.getNodePosition(e.id);
-        int dx = std::abs(pu.x - pv.x);
-        int dy = std::abs(pu.y - pv.y);
-        if (dx == 1 && dy == 1) continue; // skip diagonal
-      }
-      Cost tentative_g = gScore[u] + e.cost;
-      if (tentative_g < gScore[e.id]) {
-        parent[e.id] = u;
-        gScore[e.id] = tentative_g;
-        fScore[e.id] = tentative_g + h.compute(e.id, goal);
-        open.push({fScore[e.id], gScore[e.id], e.id});
+    std::vector<Edge> neighbors_;
+    // Successors to push after an expansion, in generation order; the improved ones among them get
+    // their heuristic in one batch.
+    std::pmr::vector<NodeId> successors_;
+    std::pmr::vector<NodeId> improved_;
+    std::pmr::vector<Cost> estimates_;
+    VisitRecorder recorder_;
+    SearchBudget budget_;
+    bool done_ = false;
+
+    static bool validInput(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config, bool informed) {
+      if (informed && !config.heuristic) {
+        LOG_ERROR("AStar: no heuristic provided in config");
+        return false;
+      }
+      if (start >= graph.getNodeCount() || goal >= graph.getNodeCount()) {
+        LOG_ERROR("AStar: invalid start/goal");
+        return false;
       }
+      return true;
     }
-  }
 
-  if (gScore[goal] == INF) {
-    res.success = false;
-    res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
-    LOG_WARN("AStar: no path found");
-    return res;
-  }
+    void push(NodeId v) {
+      AStarNode<S> node{fScore_[v], S{}, gScore_[v], v, 0};
+      if (tieBreaking_ != TieBreaking::NONE) {
+        node.f = Score::from(std::round(Score::to(node.f) / kTieResolution) * kTieResolution);
+      }
+      switch (tieBreaking_) {
+        case TieBreaking::HIGH_G:
+          node.tie = -gScore_[v];
+          break;
+        case TieBreaking::CROSS_PRODUCT: {
+          const Point p = graph_.getNodePosition(v);
+          const long cross = static_cast<long>(p.x - goalPos_.x) * (startPos_.y - goalPos_.y) -
+                             static_cast<long>(startPos_.x - goalPos_.x) * (p.y - goalPos_.y);
+          node.tie = static_cast<S>(std::labs(cross));
+          node.rank = static_cast<uint64_t>(Score::to(node.g) / kTieResolution);
+          break;
+        }
+        case TieBreaking::LIFO:
+          node.rank = ++pushCount_;
+          break;
+        case TieBreaking::NONE:
+          break;
+      }
+      open_.push(node);
+      stats_.pushed(open_.size());
+    }
+
+    void expand(NodeId u) {
+      graph_.getNeighbors(u, neighbors_);
+
+      uint16_t allowed = kAllMoves;
+      Point from{0, 0};
+      if (canonical_) {
+        from = graph_.getNodePosition(u);
+        uint16_t walkable = 0;
+        for (const Edge& e : neighbors_) {
+          const Point pv = graph_.getNodePosition(e.id);
+          walkable |= moveBit(pv.x - from.x, pv.y - from.y);
+        }
+        uint16_t done = 0;
+        allowed = 0;
+        for (int m = 0; m < 9; ++m) {
+          if (arrivals_[u] & (1u << m)) allowed |= canonicalSuccessors(m, walkable);
+          if (expandedWith_[u] & (1u << m)) done |= canonicalSuccessors(m, walkable);
+        }
+        allowed = static_cast<uint16_t>(allowed & ~done);
+        expandedWith_[u] = arrivals_[u];
+      }
+
+      successors_.clear();
+      improved_.clear();
+      for (const Edge& e : neighbors_) {
+        // option to ignore diagonals if config disallows them
+        if (!config_.allowDiagonal) {
+          Point pu = graph_.getNodePosition(u);
+          Point pv = graph_.getNodePosition(e.id);
+          int dx = std::abs(pu.x - pv.x);
+          int dy = std::abs(pu.y - pv.y);
+          if (dx == 1 && dy == 1) continue; // skip diagonal
+        }
+        uint16_t move = 0;
+        if (canonical_) {
+          const Point pv = graph_.getNodePosition(e.id);
+          move = moveBit(pv.x - from.x, pv.y - from.y);
+          if (!(allowed & move)) continue;
+        }
+        stats_.generated();
+        const S tentative_g = Score::add(gScore_[u], Score::from(e.cost));
+        if (canonical_ && gScore_[e.id] != INF &&
+            std::abs(Score::to(tentative_g) - Score::to(gScore_[e.id])) <= kSameCost * Score::to(gScore_[e.id])) {
+          if (!(arrivals_[e.id] & move)) {
+            arrivals_[e.id] = static_cast<uint16_t>(arrivals_[e.id] | move);
+            if (expandedWith_[e.id] != 0) successors_.push_back(e.id);
+          }
+          continue;
+        }
+        if (tentative_g < gScore_[e.id]) {
+          parent_.set(e.id, u);
+          gScore_[e.id] = tentative_g;
+          if (canonical_) {
+            arrivals_[e.id] = move;
+            expandedWith_[e.id] = 0;
+          }
+          successors_.push_back(e.id);
+          improved_.push_back(e.id);
+        }
+      }
+
+      if (informed_) {
+        estimates_.resize(improved_.size());
+        config_.heuristic->computeBatch(improved_.data(), improved_.size(), goal_, estimates_.data());
+      }
+      std::size_t next = 0;
+      for (const NodeId v : successors_) {
+        if (next < improved_.size() && improved_[next] == v) {
+          if (informed_) {
+            fScore_[v] = Score::fromBelow(Score::to(gScore_[v]) + w_ * estimates_[next]);
+            stats_.heuristicCall();
+          } else {
+            fScore_[v] = gScore_[v];
+          }
+          ++next;
+        }
+        push(v);
+      }
+    }
 
-  for (NodeId cur = goal; cur != static_cast<NodeId>(-1); cur = parent[cur]) {
-    res.path.push_back(cur);
-    if (cur == start) break;
+    void finish() {
+      done_ = true;
+      stats_.endSearch();
+      recorder_.flush();
+      stats_.workspace(StatsRecorder::bytes(gScore_) + StatsRecorder::bytes(fScore_) + parent_.bytes() +
+                       StatsRecorder::bytes(neighbors_) + StatsRecorder::bytes(successors_) +
+                       StatsRecorder::bytes(improved_) + StatsRecorder::bytes(estimates_) +
+                       StatsRecorder::bytes(arrivals_) + StatsRecorder::bytes(expandedWith_) +
+                       res_.stats.peakOpen * sizeof(AStarNode<S>));
+
+      // An interrupted search returns the path to the expanded node closest to the goal.
+      const bool stopped = budget_.status() != SearchStatus::SUCCESS;
+      const NodeId target = stopped ? budget_.closest() : goal_;
+
+      if (!stopped && gScore_[goal_] == INF) {
+        res_.success = false;
+        res_.status = SearchStatus::NO_PATH;
+        LOG_WARN("AStar: no path found");
+        return;
+      }
+
+      for (NodeId cur = target; cur != ParentMap::kNone; cur = parent_.get(cur)) {
+        res_.path.push_back(cur);
+        if (cur == start_) break;
+      }
+      std::reverse(res_.path.begin(), res_.path.end());
+      stats_.endReconstruct();
+
+      res_.cost = Score::kExact ? Score::to(gScore_[target]) : pathCost(graph_, res_.path);
+      res_.status = budget_.status();
+      if (stopped) {
+        LOG_WARN(std::string("AStar: stopped, partial cost=") + std::to_string(res_.cost));
+        return;
+      }
+      res_.success = true;
+      res_.suboptimalityBound = informed_ ? w_ : 1.0;
+      LOG_INFO(std::string("AStar: success cost=") + std::to_string(res_.cost));
+    }
+
+  public:
+    Search(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config, bool informed)
+        : graph_(graph),
+          config_(config),
+          start_(start),
+          goal_(goal),
+          informed_(informed),
+          w_(informed ? std::max<Cost>(1.0, config.weight) : 1.0),
+          res_(config.resultMemory),
+          stats_(res_),
+          valid_(validInput(graph, start, goal, config, informed)),
+          gScore_(valid_ ? graph.getNodeCount() : 0, INF, config.memory),
+          fScore_(valid_ ? graph.getNodeCount() : 0, INF, config.memory),
+          parent_(graph, valid_ ? graph.getNodeCount() : 0, config.memory),
+          open_(std::greater<AStarNode<S>>(), std::pmr::vector<AStarNode<S>>(config.memory)),
+          canonical_(valid_ && informed && config.canonicalOrdering && config.allowDiagonal && graph.isUniformGrid()),
+          arrivals_(canonical_ ? graph.getNodeCount() : 0, 0, config.memory),
+          expandedWith_(canonical_ ? graph.getNodeCount() : 0, 0, config.memory),
+          successors_(config.memory),
+          improved_(config.memory),
+          estimates_(config.memory),
+          recorder_(res_, config_, graph.getNodeCount()),
+          budget_(config_, start, goal) {
+      const auto t0 = std::chrono::steady_clock::now();
+      res_.success = false; res_.cost = 0.0; res_.time = Time::zero();
+      LOG_INFO(std::string("AStar: start from=") + std::to_string(start) + " to=" + std::to_string(goal));
+      if (!valid_) {
+        done_ = true;
+        return;
+      }
+      if (informed && config.canonicalOrdering && !canonical_) {
+        LOG_DEBUG("AStar: canonical ordering needs diagonal moves on a uniform-cost grid; ignored");
+      }
+
+      // A canonical path runs diagonally first and straight after, away from the start-goal line
+      // that CROSS_PRODUCT favours, so the two together expand far more than either alone.
+      // Canonical searches order those ties by HIGH_G instead.
+      if (informed) tieBreaking_ = config.tieBreaking;
+      if (canonical_ && tieBreaking_ == TieBreaking::CROSS_PRODUCT) {
+        LOG_DEBUG("AStar: CROSS_PRODUCT works against canonical ordering; using HIGH_G");
+        tieBreaking_ = TieBreaking::HIGH_G;
+      }
+      startPos_ = graph.getNodePosition(start);
+      goalPos_ = graph.getNodePosition(goal);
+
+      gScore_[start] = Score::from(0.0);
+      if (informed) {
+        fScore_[start] = Score::fromBelow(w_ * config.heuristic->compute(start, goal));
+        stats_.heuristicCall();
+      } else {
+        fScore_[start] = gScore_[start];
+      }
+      if (canonical_) arrivals_[start] = moveBit(0, 0);
+      push(start);
+      stats_.endSetup();
+      res_.time += std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+    }
+
+    bool run(std::chrono::steady_clock::time_point sliceEnd, std::size_t maxExpansions) override {
+      if (done_) return true;
+      const auto t0 = std::chrono::steady_clock::now();
+      const bool sliced = sliceEnd != std::chrono::steady_clock::time_point::max();
+      stats_.resume();
+
+      for (std::size_t expanded = 0; !done_;) {
+        if (open_.empty()) {
+          finish();
+          break;
+        }
+        const auto cur = open_.top(); open_.pop();
+        stats_.popped();
+        const NodeId u = cur.id;
+        recorder_.record(u);
+        if (u == goal_) {
+          finish();
+          break;
+        }
+        // A canonical node re-opened by an equal-cost arrival is expanded again only for its new moves.
+        if (cur.g != gScore_[u] || (canonical_ && expandedWith_[u] == arrivals_[u])) {
+          stats_.stalePop();
+          continue;
+        }
+        stats_.expanded();
+        if (budget_.exhausted(u)) {
+          finish();
+          break;
+        }
+        expand(u);
+
+        ++expanded;
+        if (maxExpansions != 0 && expanded >= maxExpansions) break;
+        if (sliced && expanded % kClockInterval == 0 && std::chrono::steady_clock::now() >= sliceEnd) break;
+      }
+
+      if (!done_) {
+        stats_.endSearch();
+        recorder_.flush();
+      }
+      res_.time += std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+      return done_;
+    }
+
+    bool done() const override { return done_; }
+
+    const Result& result() const override { return res_; }
+
+    Result release() override { return std::move(res_); }
+
+    std::size_t expansions() const override { return budget_.expansions(); }
+};
+
+} // namespace
+
+std::unique_ptr<AStarSearch> AStarSearch::create(
+    const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config, bool informed) {
+  switch (config.precision) {
+    case CostPrecision::FLOAT:
+      return std::make_unique<Search<float>>(graph, start, goal, config, informed);
+    case CostPrecision::FIXED:
+      return std::make_unique<Search<int32_t>>(graph, start, goal, config, informed);
+    case CostPrecision::DOUBLE:
+      break;
   }
-  std::reverse(res.path.begin(), res.path.end());
+  return std::make_unique<Search<double>>(graph, start, goal, config, informed);
+}
 
-  res.cost = gScore[goal];
-  res.success = true;
-  res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
-  LOG_INFO(std::string("AStar: success cost=") + std::to_string(res.cost));
-  return res;
+Result AStar::findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) {
+  const std::unique_ptr<AStarSearch> search = AStarSearch::create(graph, start, goal, config);
+  search->run();
+  return search->release();
 }
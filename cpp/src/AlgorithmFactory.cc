@@ -10,6 +10,9 @@
 #include "algorithms/AStar.hh"
 #include "algorithms/DFS.hh"
 #include "algorithms/IDAStar.hh"
+#include "algorithms/ARAStar.hh"
+#include "algorithms/FocalSearch.hh"
+#include "algorithms/ThetaStar.hh"
 #include "utils/Logger.hh"
 
 std::unique_ptr<IAlgorithm> AlgorithmFactory::createAlgorithm(AlgorithmType type) {
@@ -41,6 +44,18 @@ std::unique_ptr<IAlgorithm> AlgorithmFactory::createAlgorithm(AlgorithmType type
       // Trace behaves like BFS for now, emphasizing exploration order.
       LOG_INFO("AlgorithmFactory: creating Trace (BFS fallback)");
       return std::make_unique<BFS>();
+    case AlgorithmType::ARASTAR:
+      LOG_INFO("AlgorithmFactory: creating ARA*");
+      return std::make_unique<ARAStar>();
+    case AlgorithmType::FOCAL:
+      LOG_INFO("AlgorithmFactory: creating Focal");
+      return std::make_unique<FocalSearch>();
+    case AlgorithmType::THETASTAR:
+      LOG_INFO("AlgorithmFactory: creating Theta*");
+      return std::make_unique<ThetaStar>(false);
+    case AlgorithmType::LAZYTHETASTAR:
+      LOG_INFO("AlgorithmFactory: creating Lazy Theta*");
+      return std::make_unique<ThetaStar>(true);
     default:
       LOG_WARN("AlgorithmFactory: unknown algorithm type");
       return nullptr;
@@ -4,12 +4,19 @@
  *------------------------------------------------------------------------------------------------*/
 
 #include <chrono>
+#include <deque>
+#include <memory_resource>
 #include <queue>
 #include <vector>
 #include <algorithm>
 #include <cstdlib>
 
 #include "algorithms/BFS.hh"
+#include "algorithms/ParentMap.hh"
+#include "algorithms/ScoreTraits.hh"
+#include "algorithms/VisitRecorder.hh"
+#include "algorithms/SearchBudget.hh"
+#include "algorithms/StatsRecorder.hh"
 #include <string>
 #include "utils/Logger.hh"
 
@@ -49,11 +56,12 @@ bool violatesCornerRule(const IGraph& graph, NodeId u, NodeId v, const std::vect
 } // namespace
 
 Result BFS::findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) {
-  Result res;
+  Result res(config.resultMemory);
   res.success = false;
   res.cost = 0.0;
   res.time = Time::zero();
   const auto t0 = std::chrono::steady_clock::now();
+  StatsRecorder stats(res);
   LOG_INFO(std::string("BFS: start from=") + std::to_string(start) + " to=" + std::to_string(goal));
 
   NodeCount n = graph.getNodeCount();
@@ -62,19 +70,27 @@ Result BFS::findPath(const IGraph& graph, NodeId start, NodeId goal, const Algor
     return res;
   }
 
-  std::vector<bool> seen(n, false);
-  std::vector<NodeId> parent(n, static_cast<NodeId>(-1));
-  std::queue<NodeId> q;
+  std::pmr::memory_resource* const memory = config.memory;
+  std::pmr::vector<bool> seen(n, false, memory);
+  ParentMap parent(graph, n, memory);
+  std::queue<NodeId, std::pmr::deque<NodeId>> q{std::pmr::deque<NodeId>(memory)};
 
   q.push(start);
+  stats.pushed(q.size());
   seen[start] = true;
 
   std::vector<Edge> neighbors;
+  VisitRecorder recorder(res, config, n);
+  SearchBudget budget(config, start, goal);
+  stats.endSetup();
 
   while (!q.empty()) {
     NodeId u = q.front(); q.pop();
-    res.visited.push_back(u);
+    stats.popped();
+    recorder.record(u);
     if (u == goal) break;
+    stats.expanded();
+    if (budget.exhausted(u)) break;
     graph.getNeighbors(u, neighbors);
     for (const Edge& e : neighbors) {
       NodeId v = e.id;
@@ -88,39 +104,48 @@ Result BFS::findPath(const IGraph& graph, NodeId start, NodeId goal, const Algor
         continue;
       }
 
+      stats.generated();
       if (!seen[v]) {
         seen[v] = true;
-        parent[v] = u;
+        parent.set(v, u);
         q.push(v);
+        stats.pushed(q.size());
       }
     }
   }
+  stats.endSearch();
+  recorder.flush();
+  stats.workspace(StatsRecorder::bytes(seen) + parent.bytes() + StatsRecorder::bytes(neighbors) +
+                  res.stats.peakOpen * sizeof(NodeId));
 
-  if (!seen[goal]) {
+  // An interrupted search returns the path to the expanded node closest to the goal.
+  const bool stopped = budget.status() != SearchStatus::SUCCESS;
+  const NodeId target = stopped ? budget.closest() : goal;
+
+  if (!stopped && !seen[goal]) {
     res.success = false;
+    res.status = SearchStatus::NO_PATH;
     res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
     LOG_WARN("BFS: goal not reached");
     return res;
   }
 
   // Reconstruct path
-  for (NodeId cur = goal; cur != static_cast<NodeId>(-1); cur = parent[cur]) {
+  for (NodeId cur = target; cur != ParentMap::kNone; cur = parent.get(cur)) {
     res.path.push_back(cur);
     if (cur == start) break;
   }
   std::reverse(res.path.begin(), res.path.end());
 
-  // compute cost as sum of node costs along path (except start)
-  Cost total = 0.0;
-  for (std::size_t i = 1; i < res.path.size(); ++i) {
-    std::vector<Edge> tmp;
-    graph.getNeighbors(res.path[i-1], tmp);
-    for (const Edge& e: tmp) if (e.id == res.path[i]) { total += e.cost; break; }
+  res.cost = pathCost(graph, res.path);
+  stats.endReconstruct();
+  res.status = budget.status();
+  res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+  if (stopped) {
+    LOG_WARN(std::string("BFS: stopped, partial cost=") + std::to_string(res.cost));
+    return res;
   }
-
-  res.cost = total;
   res.success = true;
-  res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
   LOG_INFO(std::string("BFS: success cost=") + std::to_string(res.cost));
   return res;
 }
@@ -3,13 +3,157 @@
  *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
  *------------------------------------------------------------------------------------------------*/
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 #include <emscripten/bind.h>
 
 #include "api/PathfindingEngine.hh"
+#include "api/LabelCache.hh"
 #include "api/Binding.hh"
 
 using namespace emscripten;
 
+namespace {
+
+// Grid cells owned by the module: written by JS through gridBuffer() or by the bulk copy fallback.
+std::vector<uint8_t> g_grid;
+
+// Grids and results of the latest batch; results are handed out as views like g_lastResult.
+std::vector<std::vector<uint8_t>> g_batchGrids;
+std::vector<Result> g_batchResults;
+
+// Terrain layer of the latest weighted query, copied in as bytes or as floats.
+std::vector<uint8_t> g_costBytes;
+std::vector<float> g_costValues;
+
+// Result of the latest query, kept alive so path/visited can be handed out as memory views.
+Result g_lastResult;
+
+// Component labels of the grids queried with a mapVersion, kept across calls.
+LabelCache g_labels;
+
+// Tables of the latest hopDistances and costMatrix calls, handed out as views the same way.
+std::vector<uint32_t> g_lastHops;
+std::vector<Cost> g_lastCosts;
+
+template <typename T, typename Allocator>
+emscripten::val memoryView(const std::vector<T, Allocator>& v) {
+    return emscripten::val(emscripten::typed_memory_view(v.size(), v.data()));
+}
+
+// Returns the grid cells as a pointer into module memory, copying only when the array lives outside it.
+const uint8_t* gridCells(const emscripten::val& gridArray, std::size_t& length) {
+    length = gridArray["length"].as<std::size_t>();
+
+    // A byte view over module memory (from gridBuffer) is searched where it is.
+    emscripten::val wasmMemory = memoryView(g_grid)["buffer"];
+    if (gridArray["buffer"].strictlyEquals(wasmMemory) && gridArray["BYTES_PER_ELEMENT"].as<int>() == 1) {
+        return reinterpret_cast<const uint8_t*>(gridArray["byteOffset"].as<std::uintptr_t>());
+    }
+
+    // Anything else is copied in one TypedArray.set instead of element by element.
+    g_grid.resize(length);
+    memoryView(g_grid).call<void>("set", gridArray);
+    return g_grid.data();
+}
+
+// Copies a Uint8Array cost layer as bytes and any other array (Float32Array, Array) as floats, in
+// one TypedArray.set either way.
+TerrainCosts terrainCosts(const emscripten::val& costArray) {
+    TerrainCosts terrain;
+    terrain.size = costArray["length"].as<std::size_t>();
+    if (costArray["BYTES_PER_ELEMENT"].as<int>() == 1) {
+        g_costBytes.resize(terrain.size);
+        memoryView(g_costBytes).call<void>("set", costArray);
+        terrain.bytes = g_costBytes.data();
+    } else {
+        g_costValues.resize(terrain.size);
+        memoryView(g_costValues).call<void>("set", costArray);
+        terrain.values = g_costValues.data();
+    }
+    return terrain;
+}
+
+EngineOptions toEngineOptions(const api::PathfindingConfig& config) {
+    EngineOptions options;
+    options.algorithm = config.algorithm;
+    options.heuristic = config.heuristic;
+    options.allowDiagonal = config.allowDiagonal;
+    options.dontCrossCorners = config.dontCrossCorners;
+    options.bidirectional = config.bidirectional;
+    options.recording = config.recording;
+    options.recordingSampleRate = config.recordingSampleRate;
+    options.weight = config.weight;
+    options.timeBudget = Time(static_cast<Time::rep>(config.timeBudgetUs));
+    options.maxExpansions = config.maxExpansions;
+    options.tieBreaking = config.tieBreaking;
+    options.canonicalOrdering = config.canonicalOrdering;
+    options.precision = config.precision;
+    options.smoothing = config.smoothing;
+    options.chainCode = config.chainCode;
+    options.keepCellPath = config.keepCellPath;
+    return options;
+}
+
+// Points options.components at the labels of config.mapVersion, labelling the grid on the
+// version's first query. The returned labels must be held for the search; nullptr without a version.
+std::shared_ptr<const ComponentLabels> versionLabels(
+    const api::PathfindingConfig& config, const uint8_t* cells, std::size_t length, int width, int height,
+    EngineOptions& options) {
+    if (!(config.mapVersion > 0.0)) return nullptr;
+    std::shared_ptr<const ComponentLabels> labels = g_labels.labelsFor(
+        cells, length, width, height, options.terrain, static_cast<uint64_t>(config.mapVersion));
+    options.components = labels.get();
+    return labels;
+}
+
+// Builds the JS result object. Arrays are typed views over `result`, which must outlive them.
+emscripten::val toJS(const Result& result) {
+    emscripten::val jsResult = emscripten::val::object();
+    jsResult.set("path", memoryView(result.path));
+    jsResult.set("visited", memoryView(result.visited));
+    jsResult.set("visitedBitmap", memoryView(result.visitedBitmap));
+    jsResult.set("visitedDeltas", memoryView(result.visitedDeltas));
+    jsResult.set("cost", result.cost);
+    jsResult.set("success", result.success);
+    jsResult.set("suboptimalityBound", result.suboptimalityBound);
+    jsResult.set("status", result.status);
+    jsResult.set("cacheHit", result.cacheHit);
+    jsResult.set("waypoints", memoryView(result.waypoints));
+    jsResult.set("waypointCost", result.waypointCost);
+    jsResult.set("chainStart", result.chainStart);
+    jsResult.set("chainCode", memoryView(result.chainCode));
+    // Counters go out as Numbers: exact up to 2^53, far beyond any single search.
+    const SearchStats& st = result.stats;
+    emscripten::val stats = emscripten::val::object();
+    stats.set("expansions", static_cast<double>(st.expansions));
+    stats.set("generated", static_cast<double>(st.generated));
+    stats.set("pushes", static_cast<double>(st.pushes));
+    stats.set("pops", static_cast<double>(st.pops));
+    stats.set("stalePops", static_cast<double>(st.stalePops));
+    stats.set("peakOpen", static_cast<double>(st.peakOpen));
+    stats.set("heuristicCalls", static_cast<double>(st.heuristicCalls));
+    stats.set("workspaceBytes", static_cast<double>(st.workspaceBytes));
+    stats.set("setup_us", static_cast<double>(st.setupTime.count()));
+    stats.set("graphBuild_us", static_cast<double>(st.graphBuildTime.count()));
+    stats.set("search_us", static_cast<double>(st.searchTime.count()));
+    stats.set("reconstruct_us", static_cast<double>(st.reconstructTime.count()));
+    stats.set("smoothing_us", static_cast<double>(st.smoothingTime.count()));
+    jsResult.set("stats", stats);
+    // Return time as a JS Number (double) to avoid BigInt serialization issues
+    jsResult.set("time_us", static_cast<double>(result.time.count()));
+    return jsResult;
+}
+
+} // namespace
+
+emscripten::val api::PathfindingAPI::gridBuffer(int size) {
+    g_grid.assign(static_cast<std::size_t>(size > 0 ? size : 0), 0);
+    return memoryView(g_grid);
+}
+
 emscripten::val api::PathfindingAPI::findPath(
     const emscripten::val& gridArray,
     int width,
@@ -18,42 +162,240 @@ emscripten::val api::PathfindingAPI::findPath(
     int goalIndex,
     const api::PathfindingConfig& config
 ) {
-    // Convert JS array (Uint8Array or Array) -> std::vector<int>
-    std::vector<int> grid = emscripten::convertJSArrayToNumberVector<int>(gridArray);
+    std::size_t length = 0;
+    const uint8_t* cells = gridCells(gridArray, length);
+
+    EngineOptions options = toEngineOptions(config);
+    const auto labels = versionLabels(config, cells, length, width, height, options);
 
     // Call the engine
-    Result result = PathfindingEngine::findPath(
-        grid,
+    g_lastResult = PathfindingEngine::findPath(
+        cells,
+        length,
         width,
         height,
-        static_cast<NodeId>(startIndex),
-        static_cast<NodeId>(goalIndex),
-        config.algorithm,
-        config.heuristic,
-        config.allowDiagonal,
-        config.dontCrossCorners,
-        config.bidirectional
+        startIndex,
+        goalIndex,
+        options
     );
 
-    // Build JS result object
-    emscripten::val jsResult = emscripten::val::object();
+    return toJS(g_lastResult);
+}
 
-    emscripten::val jspath = emscripten::val::array();
-    for (NodeId id : result.path) jspath.call<void>("push", emscripten::val(id));
+emscripten::val api::PathfindingAPI::findPathWeighted(
+    const emscripten::val& gridArray,
+    const emscripten::val& costArray,
+    int width,
+    int height,
+    int startIndex,
+    int goalIndex,
+    const api::PathfindingConfig& config
+) {
+    std::size_t length = 0;
+    const uint8_t* cells = gridCells(gridArray, length);
 
-    emscripten::val jsvisited = emscripten::val::array();
-    for (NodeId v : result.visited) jsvisited.call<void>("push", emscripten::val(v));
+    EngineOptions options = toEngineOptions(config);
+    options.terrain = terrainCosts(costArray);
+    const auto labels = versionLabels(config, cells, length, width, height, options);
+    g_lastResult = PathfindingEngine::findPath(cells, length, width, height, startIndex, goalIndex, options);
 
-    jsResult.set("path", jspath);
-    jsResult.set("visited", jsvisited);
-    jsResult.set("cost", result.cost);
-    jsResult.set("success", result.success);
-    // Return time as a JS Number (double) to avoid BigInt serialization issues
-    jsResult.set("time_us", static_cast<double>(result.time.count()));
+    return toJS(g_lastResult);
+}
 
-    return jsResult;
+emscripten::val api::PathfindingAPI::findPathStreaming(
+    const emscripten::val& gridArray,
+    int width,
+    int height,
+    int startIndex,
+    int goalIndex,
+    const api::PathfindingConfig& config,
+    const emscripten::val& onVisited,
+    int chunkSize
+) {
+    std::size_t length = 0;
+    const uint8_t* cells = gridCells(gridArray, length);
+
+    EngineOptions options = toEngineOptions(config);
+    options.recording = VisitedRecording::STREAM;
+    options.visitChunkSize = chunkSize > 0 ? static_cast<std::size_t>(chunkSize) : 1024;
+    options.onVisited = [&onVisited](const NodeId* ids, std::size_t count) {
+        onVisited(emscripten::val(emscripten::typed_memory_view(count, ids)));
+    };
+    const auto labels = versionLabels(config, cells, length, width, height, options);
+    g_lastResult = PathfindingEngine::findPath(cells, length, width, height, startIndex, goalIndex, options);
+
+    return toJS(g_lastResult);
 }
 
+emscripten::val api::PathfindingAPI::findPathBatch(const emscripten::val& queries, int maxThreads) {
+    // JS values can only be touched from this thread: copy every grid in before the workers start.
+    const std::size_t count = queries["length"].as<std::size_t>();
+    g_batchGrids.resize(count);
+    std::vector<PathQuery> batch(count);
+    std::vector<std::shared_ptr<const ComponentLabels>> labels(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const emscripten::val query = queries[i];
+        const emscripten::val grid = query["grid"];
+        g_batchGrids[i].resize(grid["length"].as<std::size_t>());
+        memoryView(g_batchGrids[i]).call<void>("set", grid);
+
+        PathQuery& q = batch[i];
+        q.grid = g_batchGrids[i].data();
+        q.gridSize = g_batchGrids[i].size();
+        q.width = query["width"].as<int>();
+        q.height = query["height"].as<int>();
+        q.startIndex = query["startIndex"].as<int>();
+        q.goalIndex = query["goalIndex"].as<int>();
+        const api::PathfindingConfig config = query["config"].as<api::PathfindingConfig>();
+        q.options = toEngineOptions(config);
+        labels[i] = versionLabels(config, q.grid, q.gridSize, q.width, q.height, q.options);
+    }
+
+    g_batchResults = PathfindingEngine::findPaths(batch, static_cast<unsigned>(std::max(maxThreads, 0)));
+
+    emscripten::val results = emscripten::val::array();
+    for (std::size_t i = 0; i < count; ++i) results.set(i, toJS(g_batchResults[i]));
+    return results;
+}
+
+emscripten::val api::PathfindingAPI::hopDistances(
+    const emscripten::val& gridArray,
+    int width,
+    int height,
+    const emscripten::val& sources,
+    const emscripten::val& targets,
+    const api::PathfindingConfig& config
+) {
+    std::size_t length = 0;
+    const uint8_t* cells = gridCells(gridArray, length);
+
+    g_lastHops = PathfindingEngine::hopDistances(
+        cells,
+        length,
+        width,
+        height,
+        emscripten::convertJSArrayToNumberVector<int>(sources),
+        emscripten::convertJSArrayToNumberVector<int>(targets),
+        toEngineOptions(config)
+    );
+    return memoryView(g_lastHops);
+}
+
+emscripten::val api::PathfindingAPI::costMatrix(
+    const emscripten::val& gridArray,
+    int width,
+    int height,
+    const emscripten::val& sources,
+    const emscripten::val& targets,
+    const api::PathfindingConfig& config,
+    int maxThreads
+) {
+    std::size_t length = 0;
+    const uint8_t* cells = gridCells(gridArray, length);
+
+    g_lastCosts = PathfindingEngine::costMatrix(
+        cells,
+        length,
+        width,
+        height,
+        emscripten::convertJSArrayToNumberVector<int>(sources),
+        emscripten::convertJSArrayToNumberVector<int>(targets),
+        toEngineOptions(config),
+        static_cast<unsigned>(std::max(maxThreads, 0))
+    );
+    return memoryView(g_lastCosts);
+}
+
+api::PlannerAPI::PlannerAPI(
+    const emscripten::val& gridArray,
+    int width,
+    int height,
+    int startIndex,
+    int goalIndex,
+    const api::PathfindingConfig& config
+) {
+    std::size_t length = 0;
+    const uint8_t* cells = gridCells(gridArray, length);
+    planner_ = std::make_unique<IncrementalPlanner>(cells, length, width, height, startIndex, goalIndex, toEngineOptions(config));
+}
+
+void api::PlannerAPI::setStart(int index) { planner_->setStart(index); }
+
+void api::PlannerAPI::setGoal(int index) { planner_->setGoal(index); }
+
+void api::PlannerAPI::setCell(int index, bool blocked) { planner_->setCell(index, blocked); }
+
+emscripten::val api::PlannerAPI::replan() {
+    lastResult_ = planner_->replan();
+    return toJS(lastResult_);
+}
+
+api::QueryAPI::QueryAPI(
+    const emscripten::val& gridArray,
+    int width,
+    int height,
+    int startIndex,
+    int goalIndex,
+    const api::PathfindingConfig& config
+) {
+    std::size_t length = 0;
+    const uint8_t* cells = gridCells(gridArray, length);
+    query_ = std::make_unique<ResumableQuery>(cells, length, width, height, startIndex, goalIndex, toEngineOptions(config));
+}
+
+bool api::QueryAPI::step(double budgetUs) { return query_->step(Time(static_cast<Time::rep>(budgetUs))); }
+
+bool api::QueryAPI::done() const { return query_->done(); }
+
+emscripten::val api::QueryAPI::result() const { return toJS(query_->result()); }
+
+api::DatabaseAPI::DatabaseAPI(
+    const emscripten::val& gridArray,
+    int width,
+    int height,
+    const api::PathfindingConfig& config
+) {
+    std::size_t length = 0;
+    const uint8_t* cells = gridCells(gridArray, length);
+    database_ = std::make_unique<PathDatabase>(cells, length, width, height, toEngineOptions(config));
+}
+
+emscripten::val api::DatabaseAPI::findPath(int startIndex, int goalIndex) {
+    lastResult_ = database_->findPath(startIndex, goalIndex);
+    return toJS(lastResult_);
+}
+
+int api::DatabaseAPI::runCount() const { return static_cast<int>(database_->runCount()); }
+
+api::CacheAPI::CacheAPI(int capacity) : cache_(static_cast<std::size_t>(std::max(capacity, 1))) {}
+
+emscripten::val api::CacheAPI::findPath(
+    const emscripten::val& gridArray,
+    int width,
+    int height,
+    int startIndex,
+    int goalIndex,
+    const api::PathfindingConfig& config,
+    double mapVersion
+) {
+    std::size_t length = 0;
+    const uint8_t* cells = gridCells(gridArray, length);
+    lastResult_ = cache_.findPath(cells, length, width, height, startIndex, goalIndex, toEngineOptions(config),
+                                  static_cast<uint64_t>(mapVersion));
+    return toJS(lastResult_);
+}
+
+void api::CacheAPI::invalidate(double mapVersion) { cache_.invalidate(static_cast<uint64_t>(mapVersion)); }
+
+void api::CacheAPI::invalidateCell(double mapVersion, int cell, bool blocked) {
+    if (cell < 0) return;
+    cache_.invalidateCell(static_cast<uint64_t>(mapVersion), static_cast<NodeId>(cell), blocked);
+}
+
+void api::CacheAPI::clear() { cache_.clear(); }
+
+int api::CacheAPI::size() const { return static_cast<int>(cache_.size()); }
+
 EMSCRIPTEN_BINDINGS(pathfinding_api) {
     using namespace emscripten;
 
@@ -66,6 +408,10 @@ EMSCRIPTEN_BINDINGS(pathfinding_api) {
         .value("JUMPPOINT", AlgorithmType::JUMPPOINT)
         .value("ORTHOGONALJUMPPOINT", AlgorithmType::ORTHOGONALJUMPPOINT)
         .value("TRACE", AlgorithmType::TRACE)
+        .value("ARASTAR", AlgorithmType::ARASTAR)
+        .value("FOCAL", AlgorithmType::FOCAL)
+        .value("THETASTAR", AlgorithmType::THETASTAR)
+        .value("LAZYTHETASTAR", AlgorithmType::LAZYTHETASTAR)
         ;
 
     enum_<HeuristicType>("HeuristicType")
@@ -75,15 +421,100 @@ EMSCRIPTEN_BINDINGS(pathfinding_api) {
         .value("CHEBYSHEV", HeuristicType::CHEBYSHEV)
         ;
 
+    enum_<VisitedRecording>("VisitedRecording")
+        .value("OFF", VisitedRecording::OFF)
+        .value("FULL", VisitedRecording::FULL)
+        .value("SAMPLED", VisitedRecording::SAMPLED)
+        .value("BITMAP", VisitedRecording::BITMAP)
+        .value("DELTAS", VisitedRecording::DELTAS)
+        .value("STREAM", VisitedRecording::STREAM)
+        ;
+
+    enum_<SearchStatus>("SearchStatus")
+        .value("SUCCESS", SearchStatus::SUCCESS)
+        .value("NO_PATH", SearchStatus::NO_PATH)
+        .value("INVALID_INPUT", SearchStatus::INVALID_INPUT)
+        .value("TIMEOUT", SearchStatus::TIMEOUT)
+        .value("EXPANSION_LIMIT", SearchStatus::EXPANSION_LIMIT)
+        .value("CANCELLED", SearchStatus::CANCELLED)
+        ;
+
+    enum_<TieBreaking>("TieBreaking")
+        .value("NONE", TieBreaking::NONE)
+        .value("HIGH_G", TieBreaking::HIGH_G)
+        .value("CROSS_PRODUCT", TieBreaking::CROSS_PRODUCT)
+        .value("LIFO", TieBreaking::LIFO)
+        ;
+
+    enum_<CostPrecision>("CostPrecision")
+        .value("DOUBLE", CostPrecision::DOUBLE)
+        .value("FLOAT", CostPrecision::FLOAT)
+        .value("FIXED", CostPrecision::FIXED)
+        ;
+
+    enum_<PathSmoothing>("PathSmoothing")
+        .value("NONE", PathSmoothing::NONE)
+        .value("WAYPOINTS", PathSmoothing::WAYPOINTS)
+        .value("STRING_PULL", PathSmoothing::STRING_PULL)
+        ;
+
     value_object<api::PathfindingConfig>("PathfindingConfig")
         .field("algorithm", &api::PathfindingConfig::algorithm)
         .field("heuristic", &api::PathfindingConfig::heuristic)
         .field("allowDiagonal", &api::PathfindingConfig::allowDiagonal)
         .field("dontCrossCorners", &api::PathfindingConfig::dontCrossCorners)
         .field("bidirectional", &api::PathfindingConfig::bidirectional)
+        .field("recording", &api::PathfindingConfig::recording)
+        .field("recordingSampleRate", &api::PathfindingConfig::recordingSampleRate)
+        .field("weight", &api::PathfindingConfig::weight)
+        .field("timeBudgetUs", &api::PathfindingConfig::timeBudgetUs)
+        .field("maxExpansions", &api::PathfindingConfig::maxExpansions)
+        .field("tieBreaking", &api::PathfindingConfig::tieBreaking)
+        .field("canonicalOrdering", &api::PathfindingConfig::canonicalOrdering)
+        .field("precision", &api::PathfindingConfig::precision)
+        .field("smoothing", &api::PathfindingConfig::smoothing)
+        .field("chainCode", &api::PathfindingConfig::chainCode)
+        .field("keepCellPath", &api::PathfindingConfig::keepCellPath)
+        .field("mapVersion", &api::PathfindingConfig::mapVersion)
+        ;
+
+    class_<api::PlannerAPI>("IncrementalPlanner")
+        .constructor<const emscripten::val&, int, int, int, int, const api::PathfindingConfig&>()
+        .function("setStart", &api::PlannerAPI::setStart)
+        .function("setGoal", &api::PlannerAPI::setGoal)
+        .function("setCell", &api::PlannerAPI::setCell)
+        .function("replan", &api::PlannerAPI::replan)
+        ;
+
+    class_<api::QueryAPI>("ResumableQuery")
+        .constructor<const emscripten::val&, int, int, int, int, const api::PathfindingConfig&>()
+        .function("step", &api::QueryAPI::step)
+        .function("done", &api::QueryAPI::done)
+        .function("result", &api::QueryAPI::result)
+        ;
+
+    class_<api::DatabaseAPI>("PathDatabase")
+        .constructor<const emscripten::val&, int, int, const api::PathfindingConfig&>()
+        .function("findPath", &api::DatabaseAPI::findPath)
+        .function("runCount", &api::DatabaseAPI::runCount)
+        ;
+
+    class_<api::CacheAPI>("RouteCache")
+        .constructor<int>()
+        .function("findPath", &api::CacheAPI::findPath)
+        .function("invalidate", &api::CacheAPI::invalidate)
+        .function("invalidateCell", &api::CacheAPI::invalidateCell)
+        .function("clear", &api::CacheAPI::clear)
+        .function("size", &api::CacheAPI::size)
         ;
 
     class_<api::PathfindingAPI>("PathfindingAPI")
+        .class_function("gridBuffer", &api::PathfindingAPI::gridBuffer)
         .class_function("findPath", &api::PathfindingAPI::findPath)
+        .class_function("findPathWeighted", &api::PathfindingAPI::findPathWeighted)
+        .class_function("findPathStreaming", &api::PathfindingAPI::findPathStreaming)
+        .class_function("findPathBatch", &api::PathfindingAPI::findPathBatch)
+        .class_function("hopDistances", &api::PathfindingAPI::hopDistances)
+        .class_function("costMatrix", &api::PathfindingAPI::costMatrix)
         ;
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <string>
+
+#include "algorithms/ChainCode.hh"
+#include "utils/Logger.hh"
+
+namespace {
+
+constexpr int kSteps[8][2] = {{1,0},{1,-1},{0,-1},{-1,-1},{-1,0},{-1,1},{0,1},{1,1}};
+
+// Code of each move, indexed by (dy + 1) * 3 + (dx + 1); 8 marks the null move.
+constexpr uint8_t kCodeOf[9] = {3, 2, 1, 4, 8, 0, 5, 6, 7};
+
+} // namespace
+
+void ChainCode::apply(const IGraph& graph, Result& result) {
+  result.chainCode.clear();
+  if (result.path.size() < 2) return;
+  result.chainStart = result.path.front();
+  if (!encode(graph, result.path, result.chainCode)) {
+    LOG_DEBUG("ChainCode: path has non-adjacent steps, no chain code");
+  }
+}
+
+bool ChainCode::encode(const IGraph& graph, const std::pmr::vector<NodeId>& path, std::pmr::vector<uint8_t>& codes) {
+  codes.clear();
+  if (path.empty()) return true;
+  codes.reserve(path.size() - 1);
+  Point prev = graph.getNodePosition(path.front());
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    const Point p = graph.getNodePosition(path[i]);
+    const int dx = p.x - prev.x;
+    const int dy = p.y - prev.y;
+    const uint8_t code = (dx < -1 || dx > 1 || dy < -1 || dy > 1) ? 8 : kCodeOf[(dy + 1) * 3 + (dx + 1)];
+    if (code == 8) {
+      codes.clear();
+      return false;
+    }
+    codes.push_back(code);
+    prev = p;
+  }
+  return true;
+}
+
+std::vector<NodeId> ChainCode::decode(NodeId start, int width, const std::pmr::vector<uint8_t>& codes) {
+  std::vector<NodeId> path;
+  path.reserve(codes.size() + 1);
+  path.push_back(start);
+  long id = static_cast<long>(start);
+  for (const uint8_t code : codes) {
+    const Point d = step(code);
+    id += static_cast<long>(d.y) * width + d.x;
+    path.push_back(static_cast<NodeId>(id));
+  }
+  return path;
+}
+
+Point ChainCode::step(uint8_t code) {
+  const auto* s = kSteps[code & 7];
+  return Point{s[0], s[1]};
+}
@@ -5,12 +5,20 @@
 
 #include <cstdlib>
 #include "heuristics/Chebyshev.hh"
+#include "heuristics/DistanceBatch.hh"
 #include "utils/Logger.hh"
 
 Cost Chebyshev::compute(NodeId from, NodeId to) const {
   Point a = graph_->getNodePosition(from);
   Point b = graph_->getNodePosition(to);
-  Cost v = static_cast<Cost>(std::max(std::abs(a.x - b.x), std::abs(a.y - b.y)));
+  Cost v = scale_ * static_cast<Cost>(std::max(std::abs(a.x - b.x), std::abs(a.y - b.y)));
   LOG_DEBUG(std::string("Chebyshev::compute from=") + std::to_string(from) + " to=" + std::to_string(to) + " => " + std::to_string(v));
   return v;
 }
+
+void Chebyshev::computeBatch(const NodeId* from, std::size_t count, NodeId to, Cost* out) const {
+  const simd::Doubles scale = simd::Doubles::splat(scale_);
+  computeDistanceBatch(*graph_, from, count, to, out, [&](simd::Doubles dx, simd::Doubles dy) {
+    return scale * max(dx, dy);
+  });
+}
@@ -0,0 +1,181 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <string>
+
+#include "graph/ComponentLabels.hh"
+#include "utils/Logger.hh"
+#include "utils/ThreadBudget.hh"
+
+namespace {
+
+const NodeId kNoComponent = static_cast<NodeId>(-1);
+
+// Bands smaller than this are not worth a thread.
+constexpr int kMinRowsPerBand = 64;
+
+bool bitAt(const uint64_t* bits, NodeId id) { return (bits[id >> 6] >> (id & 63)) & 1u; }
+
+// Union-find over raw arrays, with path halving and union by size. Walls have parent kNoComponent.
+struct UnionFind {
+  NodeId* parent;
+  NodeCount* size;
+
+  bool has(NodeId id) const { return parent[id] != kNoComponent; }
+
+  NodeId find(NodeId id) const {
+    while (parent[id] != id) {
+      parent[id] = parent[parent[id]];
+      id = parent[id];
+    }
+    return id;
+  }
+
+  void unite(NodeId a, NodeId b) const {
+    a = find(a);
+    b = find(b);
+    if (a == b) return;
+    if (size[a] < size[b]) std::swap(a, b);
+    parent[b] = a;
+    size[a] += size[b];
+  }
+};
+
+// Links (x, y) to its already-visited neighbours: left, and the row above.
+void linkCell(const UnionFind& uf, int width, bool diagonal, int x, int y) {
+  const NodeId id = static_cast<NodeId>(y * width + x);
+  if (!uf.has(id)) return;
+  if (x > 0 && uf.has(id - 1)) uf.unite(id, id - 1);
+  if (y == 0) return;
+  const NodeId up = id - static_cast<NodeId>(width);
+  if (uf.has(up)) uf.unite(id, up);
+  if (!diagonal) return;
+  if (x > 0 && uf.has(up - 1)) uf.unite(id, up - 1);
+  if (x + 1 < width && uf.has(up + 1)) uf.unite(id, up + 1);
+}
+
+// Labels the 4-connected components of rows [firstRow, lastRow) using links inside the band only,
+// so bands can run concurrently.
+// The band's first row is linked to the row above afterwards, once every band is done.
+void linkRows(const UnionFind& uf, const uint64_t* walkBits, int width, int firstRow, int lastRow) {
+  const NodeId begin = static_cast<NodeId>(firstRow * width);
+  const NodeId end = static_cast<NodeId>(lastRow * width);
+  for (NodeId id = begin; id < end; ++id) {
+    uf.parent[id] = bitAt(walkBits, id) ? id : kNoComponent;
+    uf.size[id] = 1;
+  }
+  for (int x = 1; x < width; ++x) {
+    const NodeId id = begin + static_cast<NodeId>(x);
+    if (uf.has(id) && uf.has(id - 1)) uf.unite(id, id - 1);
+  }
+  for (int y = firstRow + 1; y < lastRow; ++y) {
+    for (int x = 0; x < width; ++x) linkCell(uf, width, false, x, y);
+  }
+}
+
+// Adds the diagonal links between rows [firstRow, lastRow) to a forest that already holds the
+// 4-connected components; 8-connected components are unions of those.
+void linkDiagonals(const UnionFind& uf, int width, int firstRow, int lastRow) {
+  for (int y = std::max(firstRow, 1); y < lastRow; ++y) {
+    for (int x = 0; x < width; ++x) {
+      const NodeId id = static_cast<NodeId>(y * width + x);
+      if (!uf.has(id)) continue;
+      const NodeId up = id - static_cast<NodeId>(width);
+      if (x > 0 && uf.has(up - 1)) uf.unite(id, up - 1);
+      if (x + 1 < width && uf.has(up + 1)) uf.unite(id, up + 1);
+    }
+  }
+}
+
+} // namespace
+
+ComponentLabels::ComponentLabels(std::pmr::memory_resource* memory)
+    : forests_{{std::pmr::vector<NodeId>(memory), std::pmr::vector<NodeCount>(memory)},
+               {std::pmr::vector<NodeId>(memory), std::pmr::vector<NodeCount>(memory)}} {}
+
+void ComponentLabels::build(int width, int height, const uint64_t* walkBits, unsigned maxThreads) {
+  width_ = width;
+  height_ = height;
+  const std::size_t n = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+
+  int bands = 1;
+  const unsigned threads = utils::threadBudget(maxThreads);
+  if (threads > 1) bands = std::max(1, std::min(static_cast<int>(threads), height_ / kMinRowsPerBand));
+  const auto bandStart = [&](int b) { return static_cast<int>(static_cast<long long>(height_) * b / bands); };
+
+  // Runs `work(firstRow, lastRow)` for every band, one thread per band where threads are available.
+  const auto forEachBand = [&](const auto& work) {
+    utils::parallelFor(static_cast<std::size_t>(bands), static_cast<unsigned>(bands), [&](std::size_t b) {
+      work(bandStart(static_cast<int>(b)), bandStart(static_cast<int>(b) + 1));
+    });
+  };
+
+  for (int diagonal = 0; diagonal < 2; ++diagonal) {
+    Forest& forest = forests_[diagonal];
+    if (diagonal) {
+      forest = forests_[0];
+    } else {
+      forest.parent.assign(n, kNoComponent);
+      forest.size.assign(n, 1);
+    }
+    const UnionFind uf{forest.parent.data(), forest.size.data()};
+
+    if (diagonal) {
+      // The flattened 4-connected roots span bands, so this pass runs on one thread. Most diagonal
+      // pairs already share a root, which makes it a cheap sweep.
+      linkDiagonals(uf, width_, 0, height_);
+    } else {
+      forEachBand([&uf, walkBits, this](int firstRow, int lastRow) {
+        linkRows(uf, walkBits, width_, firstRow, lastRow);
+      });
+      // Stitch each band's first row to the row above it.
+      for (int b = 1; b < bands; ++b) {
+        const int y = bandStart(b);
+        for (int x = 0; x < width_; ++x) linkCell(uf, width_, false, x, y);
+      }
+    }
+
+    // Point every cell straight at its root so sameComponent() is two lookups.
+    for (std::size_t i = 0; i < n; ++i) {
+      if (uf.has(static_cast<NodeId>(i))) forest.parent[i] = uf.find(static_cast<NodeId>(i));
+    }
+  }
+
+  valid_ = true;
+  LOG_DEBUG("ComponentLabels: labelled with " + std::to_string(bands) + " band(s)");
+}
+
+void ComponentLabels::open(NodeId id, const uint64_t* walkBits) {
+  if (!valid_) return;
+  const int px = static_cast<int>(id % static_cast<NodeId>(width_));
+  const int py = static_cast<int>(id / static_cast<NodeId>(width_));
+  for (int diagonal = 0; diagonal < 2; ++diagonal) {
+    Forest& forest = forests_[diagonal];
+    const UnionFind uf{forest.parent.data(), forest.size.data()};
+    forest.parent[id] = id;
+    forest.size[id] = 1;
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        if ((dx == 0 && dy == 0) || (!diagonal && dx != 0 && dy != 0)) continue;
+        const int nx = px + dx;
+        const int ny = py + dy;
+        if (nx < 0 || ny < 0 || nx >= width_ || ny >= height_) continue;
+        const NodeId nid = static_cast<NodeId>(ny * width_ + nx);
+        if (bitAt(walkBits, nid)) uf.unite(id, nid);
+      }
+    }
+  }
+}
+
+bool ComponentLabels::sameComponent(NodeId a, NodeId b, bool allowDiagonal) const {
+  const std::pmr::vector<NodeId>& parent = forests_[allowDiagonal ? 1 : 0].parent;
+  if (!valid_ || a >= parent.size() || b >= parent.size()) return true;
+  if (parent[a] == kNoComponent || parent[b] == kNoComponent) return true;
+  // Read-only find: union by size keeps the trees shallow between rebuilds.
+  while (parent[a] != a) a = parent[a];
+  while (parent[b] != b) b = parent[b];
+  return a == b;
+}
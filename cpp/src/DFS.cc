@@ -5,12 +5,19 @@
 
 #include <algorithm>
 #include <chrono>
+#include <deque>
+#include <memory_resource>
 #include <stack>
 #include <vector>
 #include <cstdlib>
 #include <string>
 
 #include "algorithms/DFS.hh"
+#include "algorithms/ParentMap.hh"
+#include "algorithms/ScoreTraits.hh"
+#include "algorithms/VisitRecorder.hh"
+#include "algorithms/SearchBudget.hh"
+#include "algorithms/StatsRecorder.hh"
 #include "utils/Logger.hh"
 
 namespace {
@@ -51,12 +58,13 @@ bool violatesCornerRule(const IGraph& graph, NodeId u, NodeId v, const std::vect
 } // namespace
 
 Result DFS::findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) {
-  Result res;
+  Result res(config.resultMemory);
   res.success = false;
   res.cost = 0.0;
   res.time = Time::zero();
 
   const auto t0 = std::chrono::steady_clock::now();
+  StatsRecorder stats(res);
 
   LOG_INFO(std::string("DFS: start from=") + std::to_string(start) + " to=" + std::to_string(goal));
 
@@ -67,19 +75,24 @@ Result DFS::findPath(const IGraph& graph, NodeId start, NodeId goal, const Algor
     return res;
   }
 
-  std::vector<bool> visited(n, false);
-  std::vector<NodeId> parent(n, static_cast<NodeId>(-1));
+  std::pmr::memory_resource* const memory = config.memory;
+  std::pmr::vector<bool> visited(n, false, memory);
+  ParentMap parent(graph, n, memory);
 
   struct StackItem {
     NodeId id;
     std::size_t nextNeighborIndex;
   };
 
-  std::stack<StackItem> st;
+  std::stack<StackItem, std::pmr::deque<StackItem>> st{std::pmr::deque<StackItem>(memory)};
   st.push({start, 0});
+  stats.pushed(st.size());
   visited[start] = true;
 
   std::vector<Edge> neighbors;
+  VisitRecorder recorder(res, config, n);
+  SearchBudget budget(config, start, goal);
+  stats.endSetup();
 
   while (!st.empty()) {
     StackItem& top = st.top();
@@ -87,8 +100,10 @@ Result DFS::findPath(const IGraph& graph, NodeId start, NodeId goal, const Algor
 
     // First time we see this node in DFS order
     if (top.nextNeighborIndex == 0) {
-      res.visited.push_back(u);
+      recorder.record(u);
       if (u == goal) break;
+      stats.expanded();
+      if (budget.exhausted(u)) break;
       graph.getNeighbors(u, neighbors);
     }
 
@@ -106,11 +121,13 @@ Result DFS::findPath(const IGraph& graph, NodeId start, NodeId goal, const Algor
         continue;
       }
 
+      stats.generated();
       if (!visited[v]) {
         visited[v] = true;
-        parent[v] = u;
+        parent.set(v, u);
         ++top.nextNeighborIndex;
         st.push({v, 0});
+        stats.pushed(st.size());
         advanced = true;
         break;
       }
@@ -118,6 +135,7 @@ Result DFS::findPath(const IGraph& graph, NodeId start, NodeId goal, const Algor
 
     if (!advanced) {
       st.pop();
+      stats.popped();
       // When we backtrack, neighbors will be refreshed for the new top on the next loop
       if (!st.empty()) {
         graph.getNeighbors(st.top().id, neighbors);
@@ -125,36 +143,39 @@ Result DFS::findPath(const IGraph& graph, NodeId start, NodeId goal, const Algor
     }
   }
 
-  if (!visited[goal]) {
+  stats.endSearch();
+  recorder.flush();
+  stats.workspace(StatsRecorder::bytes(visited) + parent.bytes() + StatsRecorder::bytes(neighbors) +
+                  res.stats.peakOpen * sizeof(StackItem));
+
+  // An interrupted search returns the path to the expanded node closest to the goal.
+  const bool stopped = budget.status() != SearchStatus::SUCCESS;
+  const NodeId target = stopped ? budget.closest() : goal;
+
+  if (!stopped && !visited[goal]) {
     res.success = false;
+    res.status = SearchStatus::NO_PATH;
     res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
     LOG_WARN("DFS: goal not reached");
     return res;
   }
 
   // Reconstruct path
-  for (NodeId cur = goal; cur != static_cast<NodeId>(-1); cur = parent[cur]) {
+  for (NodeId cur = target; cur != ParentMap::kNone; cur = parent.get(cur)) {
     res.path.push_back(cur);
     if (cur == start) break;
   }
   std::reverse(res.path.begin(), res.path.end());
 
-  // Compute cost by summing edge costs along the path
-  Cost total = 0.0;
-  for (std::size_t i = 1; i < res.path.size(); ++i) {
-    std::vector<Edge> tmp;
-    graph.getNeighbors(res.path[i - 1], tmp);
-    for (const Edge& e : tmp) {
-      if (e.id == res.path[i]) {
-        total += e.cost;
-        break;
-      }
-    }
+  res.cost = pathCost(graph, res.path);
+  stats.endReconstruct();
+  res.status = budget.status();
+  res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+  if (stopped) {
+    LOG_WARN(std::string("DFS: stopped, partial cost=") + std::to_string(res.cost));
+    return res;
   }
-
-  res.cost = total;
   res.success = true;
-  res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
   LOG_INFO(std::string("DFS: success cost=") + std::to_string(res.cost));
   return res;
 }
@@ -0,0 +1,261 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+#include "algorithms/DStarLite.hh"
+#include "algorithms/VisitRecorder.hh"
+#include "utils/Logger.hh"
+
+namespace {
+
+const Cost INF = std::numeric_limits<Cost>::infinity();
+
+} // namespace
+
+DStarLite::DStarLite(GridGraph& graph, const AlgorithmConfig& config, NodeId start, NodeId goal)
+    : graph_(graph), config_(config), start_(start), goal_(goal), lastStart_(start) {}
+
+void DStarLite::initialize() {
+  const NodeCount n = graph_.getNodeCount();
+  g_.assign(n, INF);
+  rhs_.assign(n, INF);
+  openKey_.assign(n, Key{INF, INF});
+  inOpen_.assign(n, false);
+  open_ = decltype(open_)();
+  km_ = 0.0;
+  lastStart_ = start_;
+
+  rhs_[goal_] = 0.0;
+  openKey_[goal_] = calculateKey(goal_);
+  inOpen_[goal_] = true;
+  open_.push({openKey_[goal_], goal_});
+  initialized_ = true;
+}
+
+DStarLite::Key DStarLite::calculateKey(NodeId s) {
+  if (stats_) stats_->heuristicCall();
+  const Cost m = std::min(g_[s], rhs_[s]);
+  return Key{m + config_.heuristic->compute(start_, s) + km_, m};
+}
+
+// Whether the diagonal and corner rules allow a move between two neighbouring cells.
+bool DStarLite::moveAllowed(Point from, Point to) const {
+  if (from.x == to.x || from.y == to.y) return true;
+  if (!config_.allowDiagonal) return false;
+  if (!config_.dontCrossCorners) return true;
+  const int width = graph_.getWidth();
+  return graph_.isWalkable(static_cast<NodeId>(from.y * width + to.x)) &&
+         graph_.isWalkable(static_cast<NodeId>(to.y * width + from.x));
+}
+
+// Moves out of u, at the cost of entering each target. A wall has no moves.
+void DStarLite::collectSuccessors(NodeId u, std::vector<Edge>& out) const {
+  out.clear();
+  if (!graph_.isWalkable(u)) return;
+  graph_.getNeighbors(u, out);
+
+  const Point pu = graph_.getNodePosition(u);
+  out.erase(std::remove_if(out.begin(), out.end(),
+                           [&](const Edge& e) { return !moveAllowed(pu, graph_.getNodePosition(e.id)); }),
+            out.end());
+}
+
+// Moves into u, each at its own cost: with terrain, entering u costs what u costs, not what the
+// reverse move would. Nothing moves into a wall.
+void DStarLite::collectPredecessors(NodeId u, std::vector<Edge>& out) const {
+  out.clear();
+  if (!graph_.isWalkable(u)) return;
+
+  const Point pu = graph_.getNodePosition(u);
+  for (int dy = -1; dy <= 1; ++dy) {
+    for (int dx = -1; dx <= 1; ++dx) {
+      const Point pv{pu.x + dx, pu.y + dy};
+      if ((dx == 0 && dy == 0) || pv.x < 0 || pv.y < 0 || pv.x >= graph_.getWidth() || pv.y >= graph_.getHeight()) {
+        continue;
+      }
+      const NodeId v = static_cast<NodeId>(pv.y * graph_.getWidth() + pv.x);
+      if (!graph_.isWalkable(v) || !moveAllowed(pv, pu)) continue;
+      const Cost cost = graph_.getEdgeCost(v, u);
+      if (cost < INF) out.push_back(Edge{v, cost});
+    }
+  }
+}
+
+void DStarLite::updateVertex(NodeId u) {
+  if (u != goal_) {
+    Cost best = INF;
+    collectSuccessors(u, edges_);
+    for (const Edge& e : edges_) best = std::min(best, e.cost + g_[e.id]);
+    rhs_[u] = best;
+  }
+
+  // The heap is lazy: stale entries are skipped when they reach the top.
+  inOpen_[u] = false;
+  if (g_[u] != rhs_[u]) {
+    openKey_[u] = calculateKey(u);
+    inOpen_[u] = true;
+    open_.push({openKey_[u], u});
+    if (stats_) stats_->pushed(open_.size());
+  }
+}
+
+bool DStarLite::topKey(Key& key) {
+  while (!open_.empty()) {
+    const OpenEntry& top = open_.top();
+    if (inOpen_[top.id] && top.key == openKey_[top.id]) {
+      key = top.key;
+      return true;
+    }
+    open_.pop();
+    if (stats_) {
+      stats_->popped();
+      stats_->stalePop();
+    }
+  }
+  return false;
+}
+
+void DStarLite::computeShortestPath(Result& res, StatsRecorder& stats) {
+  VisitRecorder recorder(res, config_, graph_.getNodeCount());
+  Key top;
+
+  while (topKey(top) && (top < calculateKey(start_) || rhs_[start_] != g_[start_])) {
+    const NodeId u = open_.top().id;
+    open_.pop();
+    stats.popped();
+
+    const Key fresh = calculateKey(u);
+    if (top < fresh) {
+      openKey_[u] = fresh;
+      open_.push({fresh, u});
+      stats.pushed(open_.size());
+      continue;
+    }
+    inOpen_[u] = false;
+    recorder.record(u);
+    stats.expanded();
+
+    if (g_[u] > rhs_[u]) {
+      g_[u] = rhs_[u];
+    } else {
+      g_[u] = INF;
+      updateVertex(u);
+    }
+
+    // g(u) changed, so every cell whose rhs reads it is due for an update.
+    collectPredecessors(u, scratch_);
+    for (const Edge& e : scratch_) {
+      stats.generated();
+      updateVertex(e.id);
+    }
+  }
+  recorder.flush();
+}
+
+void DStarLite::setStart(NodeId start) {
+  if (initialized_) {
+    km_ += config_.heuristic->compute(lastStart_, start);
+    lastStart_ = start;
+  }
+  start_ = start;
+}
+
+void DStarLite::setGoal(NodeId goal) {
+  goal_ = goal;
+  initialized_ = false;
+}
+
+void DStarLite::setCell(NodeId cell, bool blocked) {
+  if (cell >= graph_.getNodeCount()) {
+    LOG_WARN("D* Lite: setCell invalid cell=" + std::to_string(cell));
+    return;
+  }
+  if (graph_.isWalkable(cell) == !blocked) return;
+  graph_.setWalkable(cell, !blocked);
+  if (!initialized_) return;
+
+  // Every edge touching the cell, including diagonals cutting its corner, ends in its 3x3 block.
+  const Point p = graph_.getNodePosition(cell);
+  for (int dy = -1; dy <= 1; ++dy) {
+    for (int dx = -1; dx <= 1; ++dx) {
+      const int x = p.x + dx;
+      const int y = p.y + dy;
+      if (x < 0 || y < 0 || x >= graph_.getWidth() || y >= graph_.getHeight()) continue;
+      updateVertex(static_cast<NodeId>(y * graph_.getWidth() + x));
+    }
+  }
+}
+
+Result DStarLite::replan() {
+  Result res(config_.resultMemory); res.success = false; res.cost = 0.0; res.time = Time::zero();
+  const auto t0 = std::chrono::steady_clock::now();
+  StatsRecorder stats(res);
+
+  LOG_INFO(std::string("D* Lite: replan from=") + std::to_string(start_) + " to=" + std::to_string(goal_));
+
+  if (!config_.heuristic) {
+    LOG_ERROR("D* Lite: no heuristic provided in config");
+    return res;
+  }
+
+  const NodeCount n = graph_.getNodeCount();
+  if (start_ >= n || goal_ >= n) {
+    LOG_ERROR("D* Lite: invalid start/goal");
+    return res;
+  }
+
+  stats_ = &stats;
+  if (!initialized_) initialize();
+  stats.endSetup();
+  computeShortestPath(res, stats);
+  stats.endSearch();
+  stats.workspace(StatsRecorder::bytes(g_) + StatsRecorder::bytes(rhs_) + StatsRecorder::bytes(openKey_) +
+                  StatsRecorder::bytes(inOpen_) + open_.size() * sizeof(OpenEntry));
+  stats_ = nullptr;
+
+  if (g_[start_] == INF) {
+    res.status = SearchStatus::NO_PATH;
+    res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+    LOG_WARN("D* Lite: no path found");
+    return res;
+  }
+
+  // Walk downhill on g from the start; every step strictly approaches the goal.
+  Cost total = 0.0;
+  NodeId cur = start_;
+  res.path.push_back(cur);
+  while (cur != goal_ && res.path.size() <= n) {
+    collectSuccessors(cur, edges_);
+    const Edge* best = nullptr;
+    for (const Edge& e : edges_) {
+      if (!best || e.cost + g_[e.id] < best->cost + g_[best->id]) best = &e;
+    }
+    if (!best || g_[best->id] == INF) break;
+    total += best->cost;
+    cur = best->id;
+    res.path.push_back(cur);
+  }
+
+  if (cur != goal_) {
+    res.path.clear();
+    res.status = SearchStatus::NO_PATH;
+    res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+    LOG_WARN("D* Lite: path extraction failed");
+    return res;
+  }
+
+  stats.endReconstruct();
+  res.cost = total;
+  res.success = true;
+  res.status = SearchStatus::SUCCESS;
+  res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+  LOG_INFO(std::string("D* Lite: success cost=") + std::to_string(res.cost));
+  return res;
+}
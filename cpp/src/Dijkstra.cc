@@ -5,18 +5,31 @@
 
 #include <limits>
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <memory_resource>
 #include <chrono>
 #include <queue>
 #include <vector>
 #include <string>
 
 #include "algorithms/Dijkstra.hh"
+#include "algorithms/ParentMap.hh"
+#include "algorithms/ScoreTraits.hh"
+#include "algorithms/VisitRecorder.hh"
+#include "algorithms/SearchBudget.hh"
+#include "algorithms/StatsRecorder.hh"
 #include "utils/Logger.hh"
 
-Result Dijkstra::findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) {
-  Result res; res.success = false; res.cost = 0.0; res.time = Time::zero();
+namespace {
+
+// S is the score type chosen by CostPrecision.
+template <typename S>
+Result search(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) {
+  using Score = ScoreTraits<S>;
+  Result res(config.resultMemory); res.success = false; res.cost = 0.0; res.time = Time::zero();
   const auto t0 = std::chrono::steady_clock::now();
+  StatsRecorder stats(res);
 
   LOG_INFO(std::string("Dijkstra: start from=") + std::to_string(start) + " to=" + std::to_string(goal));
 
@@ -27,22 +40,33 @@ Result Dijkstra::findPath(const IGraph& graph, NodeId start, NodeId goal, const
     return res;
   }
 
-  const Cost INF = std::numeric_limits<Cost>::infinity();
-  std::vector<Cost> dist(n, INF);
-  std::vector<NodeId> parent(n, static_cast<NodeId>(-1));
-  using Pair = std::pair<Cost, NodeId>;
-  std::priority_queue<Pair, std::vector<Pair>, std::greater<Pair>> pq;
+  std::pmr::memory_resource* const memory = config.memory;
+  const S INF = Score::infinity();
+  std::pmr::vector<S> dist(n, INF, memory);
+  ParentMap parent(graph, n, memory);
+  using Pair = std::pair<S, NodeId>;
+  std::priority_queue<Pair, std::pmr::vector<Pair>, std::greater<Pair>> pq{std::greater<Pair>(), std::pmr::vector<Pair>(memory)};
 
-  dist[start] = 0.0;
-  pq.push({0.0, start});
+  dist[start] = Score::from(0.0);
+  pq.push({dist[start], start});
+  stats.pushed(pq.size());
 
   std::vector<Edge> neighbors;
+  VisitRecorder recorder(res, config, n);
+  SearchBudget budget(config, start, goal);
+  stats.endSetup();
 
   while (!pq.empty()) {
     auto [d,u] = pq.top(); pq.pop();
-    if (d != dist[u]) continue;
-    res.visited.push_back(u);
+    stats.popped();
+    if (d != dist[u]) {
+      stats.stalePop();
+      continue;
+    }
+    recorder.record(u);
     if (u == goal) break;
+    stats.expanded();
+    if (budget.exhausted(u)) break;
     graph.getNeighbors(u, neighbors);
     for (const Edge& e : neighbors) {
       // If diagonals are disabled in config, skip diagonal neighbors.
@@ -54,33 +78,64 @@ Result Dijkstra::findPath(const IGraph& graph, NodeId start, NodeId goal, const
         if (dx == 1 && dy == 1) continue; // skip diagonal
       }
 
+      stats.generated();
       NodeId v = e.id;
-      Cost nd = dist[u] + e.cost;
+      const S nd = Score::add(dist[u], Score::from(e.cost));
       if (nd < dist[v]) {
         dist[v] = nd;
-        parent[v] = u;
+        parent.set(v, u);
         pq.push({nd, v});
+        stats.pushed(pq.size());
       }
     }
   }
+  stats.endSearch();
+  recorder.flush();
+  stats.workspace(StatsRecorder::bytes(dist) + parent.bytes() + StatsRecorder::bytes(neighbors) +
+                  res.stats.peakOpen * sizeof(Pair));
+
+  // An interrupted search returns the path to the expanded node closest to the goal.
+  const bool stopped = budget.status() != SearchStatus::SUCCESS;
+  const NodeId target = stopped ? budget.closest() : goal;
 
-  if (dist[goal] == INF) {
+  if (!stopped && dist[goal] == INF) {
     res.success = false;
+    res.status = SearchStatus::NO_PATH;
     res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
     LOG_WARN("Dijkstra: no path found");
     return res;
   }
 
   // reconstruct path
-  for (NodeId cur = goal; cur != static_cast<NodeId>(-1); cur = parent[cur]) {
+  for (NodeId cur = target; cur != ParentMap::kNone; cur = parent.get(cur)) {
     res.path.push_back(cur);
     if (cur == start) break;
   }
   std::reverse(res.path.begin(), res.path.end());
+  stats.endReconstruct();
 
-  res.cost = dist[goal];
-  res.success = true;
+  res.cost = Score::kExact ? Score::to(dist[target]) : pathCost(graph, res.path);
+  res.status = budget.status();
   res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+  if (stopped) {
+    LOG_WARN(std::string("Dijkstra: stopped, partial cost=") + std::to_string(res.cost));
+    return res;
+  }
+  res.success = true;
   LOG_INFO(std::string("Dijkstra: success cost=") + std::to_string(res.cost));
   return res;
 }
+
+} // namespace
+
+Result Dijkstra::findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) {
+  switch (config.precision) {
+    case CostPrecision::FLOAT:
+      return search<float>(graph, start, goal, config);
+    case CostPrecision::FIXED:
+      return search<int32_t>(graph, start, goal, config);
+    case CostPrecision::DOUBLE:
+      break;
+  }
+  return search<double>(graph, start, goal, config);
+}
@@ -0,0 +1,107 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "algorithms/DistanceMatrix.hh"
+#include "algorithms/DijkstraWorkspace.hh"
+#include "utils/Logger.hh"
+#include "utils/QueryArena.hh"
+#include "utils/ThreadBudget.hh"
+
+namespace {
+
+constexpr std::size_t kNoColumn = static_cast<std::size_t>(-1);
+constexpr Cost kInfinity = std::numeric_limits<Cost>::infinity();
+
+// The columns of every target cell, as lists threaded through nextColumn (a cell may be listed
+// more than once), and the distinct target cells.
+struct TargetIndex {
+  std::vector<std::size_t> firstColumn;
+  std::vector<std::size_t> nextColumn;
+  std::vector<NodeId> cells;
+};
+
+// A worker's search state, allocated from its own arena and reused from one source to the next.
+struct Workspace {
+  utils::QueryArena::Scope arena;
+  DijkstraWorkspace search;
+  std::vector<Edge> neighbors;
+
+  explicit Workspace(NodeCount n) : search(n, arena.resource()) {}
+};
+
+bool isDiagonalMove(const IGraph& graph, NodeId u, NodeId v) {
+  const Point pu = graph.getNodePosition(u);
+  const Point pv = graph.getNodePosition(v);
+  return std::abs(pu.x - pv.x) == 1 && std::abs(pu.y - pv.y) == 1;
+}
+
+// Fills the row of one source: Dijkstra until every target it may reach is settled.
+void searchFrom(const IGraph& graph, NodeId source, const TargetIndex& index, bool allowDiagonal,
+                const DistanceMatrix::ReachFilter& mayReach, Workspace& ws, Cost* row) {
+  std::size_t pending = 0;
+  for (const NodeId cell : index.cells) {
+    if (!mayReach || mayReach(source, cell)) ++pending;
+  }
+  if (pending == 0) return;
+
+  ws.search.start(source);
+  Cost d;
+  NodeId u;
+  while (ws.search.pop(d, u)) {
+    if (index.firstColumn[u] != kNoColumn) {
+      for (std::size_t t = index.firstColumn[u]; t != kNoColumn; t = index.nextColumn[t]) row[t] = d;
+      if ((!mayReach || mayReach(source, u)) && --pending == 0) break;
+    }
+
+    graph.getNeighbors(u, ws.neighbors);
+    for (const Edge& e : ws.neighbors) {
+      if (!allowDiagonal && isDiagonalMove(graph, u, e.id)) continue;
+      const Cost nd = d + e.cost;
+      if (nd < ws.search.dist(e.id)) ws.search.improve(e.id, nd);
+    }
+  }
+  ws.search.reset();
+}
+
+} // namespace
+
+std::vector<Cost> DistanceMatrix::compute(
+    const IGraph& graph,
+    const std::vector<NodeId>& sources,
+    const std::vector<NodeId>& targets,
+    bool allowDiagonal,
+    unsigned maxThreads,
+    const ReachFilter& mayReach) {
+  const NodeCount n = graph.getNodeCount();
+  const std::size_t columns = targets.size();
+  LOG_INFO("DistanceMatrix: " + std::to_string(sources.size()) + "x" + std::to_string(columns) + " over " +
+           std::to_string(n) + " nodes");
+  std::vector<Cost> matrix(sources.size() * columns, kInfinity);
+
+  TargetIndex index;
+  index.firstColumn.assign(n, kNoColumn);
+  index.nextColumn.assign(columns, kNoColumn);
+  for (std::size_t t = columns; t-- > 0;) {
+    const NodeId cell = targets[t];
+    if (cell >= n) continue;
+    if (index.firstColumn[cell] == kNoColumn) index.cells.push_back(cell);
+    index.nextColumn[t] = index.firstColumn[cell];
+    index.firstColumn[cell] = t;
+  }
+  if (index.cells.empty() || sources.empty()) return matrix;
+
+  // Each source writes only its own row.
+  utils::parallelFor(sources.size(), maxThreads, [n] { return Workspace(n); }, [&](std::size_t s, Workspace& ws) {
+    if (sources[s] >= n) return;
+    searchFrom(graph, sources[s], index, allowDiagonal, mayReach, ws, &matrix[s * columns]);
+  });
+  return matrix;
+}
@@ -5,6 +5,7 @@
 
 #include <cmath>
 #include "heuristics/Euclidean.hh"
+#include "heuristics/DistanceBatch.hh"
 #include "utils/Logger.hh"
 
 Cost Euclidean::compute(NodeId from, NodeId to) const {
@@ -12,7 +13,14 @@ Cost Euclidean::compute(NodeId from, NodeId to) const {
   Point b = graph_->getNodePosition(to);
   double dx = static_cast<double>(a.x - b.x);
   double dy = static_cast<double>(a.y - b.y);
-  Cost v = static_cast<Cost>(std::sqrt(dx*dx + dy*dy));
+  Cost v = scale_ * static_cast<Cost>(std::sqrt(dx*dx + dy*dy));
   LOG_DEBUG(std::string("Euclidean::compute from=") + std::to_string(from) + " to=" + std::to_string(to) + " => " + std::to_string(v));
   return v;
 }
+
+void Euclidean::computeBatch(const NodeId* from, std::size_t count, NodeId to, Cost* out) const {
+  const simd::Doubles scale = simd::Doubles::splat(scale_);
+  computeDistanceBatch(*graph_, from, count, to, out, [&](simd::Doubles dx, simd::Doubles dy) {
+    return scale * sqrt(dx * dx + dy * dy);
+  });
+}
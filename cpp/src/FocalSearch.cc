@@ -0,0 +1,220 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "algorithms/FocalSearch.hh"
+#include "algorithms/VisitRecorder.hh"
+#include "algorithms/SearchBudget.hh"
+#include "algorithms/StatsRecorder.hh"
+#include "utils/Logger.hh"
+
+namespace {
+
+bool isDiagonalMove(const IGraph& graph, NodeId u, NodeId v) {
+  Point pu = graph.getNodePosition(u);
+  Point pv = graph.getNodePosition(v);
+  int dx = std::abs(pu.x - pv.x);
+  int dy = std::abs(pu.y - pv.y);
+  return dx == 1 && dy == 1;
+}
+
+bool violatesCornerRule(const IGraph& graph, NodeId u, NodeId v, const std::vector<Edge>& neighbors) {
+  Point pu = graph.getNodePosition(u);
+  Point pv = graph.getNodePosition(v);
+
+  int dx = std::abs(pu.x - pv.x);
+  int dy = std::abs(pu.y - pv.y);
+  if (dx != 1 || dy != 1) return false;
+
+  Point p1{pv.x, pu.y};
+  Point p2{pu.x, pv.y};
+
+  bool hasP1 = false;
+  bool hasP2 = false;
+
+  for (const Edge& e : neighbors) {
+    Point pn = graph.getNodePosition(e.id);
+    if (pn.x == p1.x && pn.y == p1.y) hasP1 = true;
+    if (pn.x == p2.x && pn.y == p2.y) hasP2 = true;
+  }
+
+  return !(hasP1 && hasP2);
+}
+
+} // namespace
+
+Result FocalSearch::findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) {
+  Result res(config.resultMemory); res.success = false; res.cost = 0.0; res.time = Time::zero();
+  const auto t0 = std::chrono::steady_clock::now();
+  StatsRecorder stats(res);
+
+  LOG_INFO(std::string("Focal: start from=") + std::to_string(start) + " to=" + std::to_string(goal));
+
+  if (!config.heuristic) {
+    LOG_ERROR("Focal: no heuristic provided in config");
+    return res;
+  }
+  const IHeuristic& h = *config.heuristic;
+
+  NodeCount n = graph.getNodeCount();
+  if (start >= n || goal >= n) {
+    LOG_ERROR("Focal: invalid start/goal");
+    return res;
+  }
+
+  const Cost INF = std::numeric_limits<Cost>::infinity();
+  const Cost w = std::max<Cost>(1.0, config.weight);
+
+  std::vector<Cost> gScore(n, INF);
+  std::vector<Cost> fScore(n, INF);
+  std::vector<Cost> hScore(n, -1.0);
+  std::vector<NodeId> parent(n, static_cast<NodeId>(-1));
+  std::vector<bool> inOpen(n, false);
+  std::vector<bool> inFocal(n, false);
+
+  // OPEN ordered by f; FOCAL ordered by distance-to-go, ties broken by f.
+  std::set<std::pair<Cost, NodeId>> open;
+  std::set<std::tuple<Cost, Cost, NodeId>> focal;
+  Cost focalBound = 0.0;
+
+  const auto insert = [&](NodeId v) {
+    if (hScore[v] < 0.0) {
+      hScore[v] = h.compute(v, goal);
+      stats.heuristicCall();
+    }
+    fScore[v] = gScore[v] + hScore[v];
+    open.insert({fScore[v], v});
+    stats.pushed(open.size());
+    inOpen[v] = true;
+    if (fScore[v] <= focalBound) {
+      focal.insert({hScore[v], fScore[v], v});
+      inFocal[v] = true;
+    }
+  };
+
+  const auto remove = [&](NodeId v) {
+    open.erase({fScore[v], v});
+    inOpen[v] = false;
+    if (inFocal[v]) {
+      focal.erase({hScore[v], fScore[v], v});
+      inFocal[v] = false;
+    }
+  };
+
+  gScore[start] = 0.0;
+  insert(start);
+
+  std::vector<Edge> neighbors;
+  VisitRecorder recorder(res, config, n);
+  SearchBudget budget(config, start, goal);
+  Cost fminAtGoal = INF;
+  stats.endSetup();
+
+  while (!open.empty()) {
+    // Keep FOCAL = { v in OPEN : f(v) <= w * fmin }. Growing the bound pulls nodes in from OPEN;
+    // a shrinking one (inconsistent heuristics) is applied lazily when FOCAL is popped.
+    const Cost fmin = open.begin()->first;
+    const Cost bound = w * fmin;
+    if (bound > focalBound) {
+      for (auto it = open.upper_bound({focalBound, std::numeric_limits<NodeId>::max()});
+           it != open.end() && it->first <= bound; ++it) {
+        NodeId v = it->second;
+        if (!inFocal[v]) {
+          focal.insert({hScore[v], fScore[v], v});
+          inFocal[v] = true;
+        }
+      }
+    }
+    focalBound = bound;
+
+    while (!focal.empty() && std::get<1>(*focal.begin()) > focalBound) {
+      inFocal[std::get<2>(*focal.begin())] = false;
+      focal.erase(focal.begin());
+      stats.stalePop();
+    }
+
+    NodeId u = focal.empty() ? open.begin()->second : std::get<2>(*focal.begin());
+    remove(u);
+    stats.popped();
+    recorder.record(u);
+    if (u == goal) {
+      fminAtGoal = fmin;
+      break;
+    }
+    stats.expanded();
+    if (budget.exhausted(u)) break;
+
+    graph.getNeighbors(u, neighbors);
+    for (const Edge& e : neighbors) {
+      if (!config.allowDiagonal && isDiagonalMove(graph, u, e.id)) {
+        continue;
+      }
+      if (config.allowDiagonal && config.dontCrossCorners && isDiagonalMove(graph, u, e.id) &&
+          violatesCornerRule(graph, u, e.id, neighbors)) {
+        continue;
+      }
+      stats.generated();
+      Cost tentative_g = gScore[u] + e.cost;
+      if (tentative_g < gScore[e.id]) {
+        if (inOpen[e.id]) remove(e.id);
+        parent[e.id] = u;
+        gScore[e.id] = tentative_g;
+        insert(e.id);
+      }
+    }
+  }
+
+  stats.endSearch();
+  recorder.flush();
+  // OPEN and FOCAL are std::sets: each entry costs its value plus three pointers and a colour word.
+  stats.workspace(StatsRecorder::bytes(gScore) + StatsRecorder::bytes(fScore) + StatsRecorder::bytes(hScore) +
+                  StatsRecorder::bytes(parent) + StatsRecorder::bytes(inOpen) + StatsRecorder::bytes(inFocal) +
+                  StatsRecorder::bytes(neighbors) +
+                  res.stats.peakOpen * (sizeof(std::tuple<Cost, Cost, NodeId>) + 4 * sizeof(void*)) * 2);
+
+  // An interrupted search returns the path to the expanded node closest to the goal.
+  const bool stopped = budget.status() != SearchStatus::SUCCESS;
+  const NodeId target = stopped ? budget.closest() : goal;
+
+  if (!stopped && (gScore[goal] == INF || fminAtGoal == INF)) {
+    res.success = false;
+    res.status = SearchStatus::NO_PATH;
+    res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+    LOG_WARN("Focal: no path found");
+    return res;
+  }
+
+  for (NodeId cur = target; cur != static_cast<NodeId>(-1); cur = parent[cur]) {
+    res.path.push_back(cur);
+    if (cur == start) break;
+  }
+  std::reverse(res.path.begin(), res.path.end());
+  stats.endReconstruct();
+
+  res.status = budget.status();
+  if (stopped) {
+    res.cost = gScore[target];
+    res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+    LOG_WARN(std::string("Focal: stopped, partial cost=") + std::to_string(res.cost));
+    return res;
+  }
+
+  // fmin never exceeds the optimal cost, so cost / fmin is a bound the solution provably meets.
+  res.cost = gScore[goal];
+  res.suboptimalityBound = fminAtGoal > 0.0 ? std::max<Cost>(1.0, std::min(w, res.cost / fminAtGoal)) : 1.0;
+  res.success = true;
+  res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+  LOG_INFO(std::string("Focal: success cost=") + std::to_string(res.cost) + " bound=" + std::to_string(res.suboptimalityBound));
+  return res;
+}
@@ -5,13 +5,70 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <stdexcept>
 
 #include "graph/GridGraph.hh"
+#include "simd/Simd.hh"
 #include "utils/Logger.hh"
 
+namespace {
+
+// Neighbour offsets, in the order of GridGraph's neighbour-mask bits: the four straight moves, then
+// the four diagonals.
+constexpr int kOffsets[8][2] = {{1,0},{-1,0},{0,1},{0,-1},{1,1},{1,-1},{-1,1},{-1,-1}};
+constexpr int kFirstDiagonal = 4;
+constexpr int kOpposite[8] = {1, 0, 3, 2, 7, 6, 5, 4};
+
+const Cost kSqrt2 = static_cast<Cost>(std::sqrt(2.0));
+
+// Neighbour mask of cell x in a row, given the walkability flags (0x00 / 0xFF) of the rows above,
+// at and below it (kOffsets' dy = -1, 0, 1).
+uint8_t neighborMaskAt(const uint8_t* const rows[3], int width, int x) {
+  uint8_t mask = 0;
+  for (int d = 0; d < 8; ++d) {
+    const int nx = x + kOffsets[d][0];
+    if (nx < 0 || nx >= width) continue;
+    if (rows[kOffsets[d][1] + 1][nx] & 0x80) mask = static_cast<uint8_t>(mask | (1u << d));
+  }
+  return mask;
+}
+
+// Fills masks[y * width + x] for every cell from the walkability flags. Rows outside the grid read
+// as blocked; inside a row, cells whose eight neighbours are all in bounds are done Bytes::kLanes at
+// a time by masking each shifted row load down to its direction bit, the edge columns one by one.
+void buildNeighborMasks(const uint8_t* flags, int width, int height, uint8_t* masks) {
+  const std::size_t w = static_cast<std::size_t>(width);
+  const std::vector<uint8_t> blocked(w, 0);
+  simd::Bytes bits[8];
+  for (int d = 0; d < 8; ++d) bits[d] = simd::Bytes::splat(static_cast<uint8_t>(1u << d));
+
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* const row = flags + static_cast<std::size_t>(y) * w;
+    const uint8_t* const rows[3] = {y > 0 ? row - w : blocked.data(), row, y + 1 < height ? row + w : blocked.data()};
+    uint8_t* const out = masks + static_cast<std::size_t>(y) * w;
+
+    int x = 1;
+    for (; x + static_cast<int>(simd::Bytes::kLanes) < width; x += static_cast<int>(simd::Bytes::kLanes)) {
+      simd::Bytes mask = simd::Bytes::splat(0);
+      for (int d = 0; d < 8; ++d) {
+        mask = mask | (simd::Bytes::load(rows[kOffsets[d][1] + 1] + x + kOffsets[d][0]) & bits[d]);
+      }
+      mask.store(out + x);
+    }
+    if (width > 0) out[0] = neighborMaskAt(rows, width, 0);
+    for (; x < width; ++x) out[x] = neighborMaskAt(rows, width, x);
+  }
+}
+
+} // namespace
+
 GridGraph::GridGraph(int width, int height, const std::vector<Node>& nodes)
-    : nodes_(nodes), width_(width), height_(height) {
+    : GridGraph(width, height, nodes.data(), nodes.size(), std::pmr::get_default_resource()) {}
+
+GridGraph::GridGraph(int width, int height, const Node* nodes, std::size_t count, std::pmr::memory_resource* memory)
+    : nodes_(nodes, nodes + count, memory), width_(width), height_(height), neighborMask_(memory),
+      enterCost_(memory), walkBits_(memory), components_(memory) {
   LOG_INFO("GridGraph ctor: width=" + std::to_string(width) + " height=" + std::to_string(height) + " nodes=" + std::to_string(nodes_.size()));
   // Validate size; if mismatch, attempt to resize or throw
   const std::size_t expected = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
@@ -30,6 +87,29 @@ GridGraph::GridGraph(int width, int height, const std::vector<Node>& nodes)
       throw std::invalid_argument("nodes.size() does not match width*height");
     }
   }
+
+  const std::size_t n = nodes_.size();
+  enterCost_.resize(2 * n);
+  bool anyWalkable = false;
+  for (std::size_t i = 0; i < n; ++i) {
+    enterCost_[2 * i] = nodes_[i].cost;
+    enterCost_[2 * i + 1] = nodes_[i].cost * kSqrt2;
+    if (!nodes_[i].walkable) continue;
+    if (!anyWalkable) {
+      minCost_ = nodes_[i].cost;
+      anyWalkable = true;
+    } else if (nodes_[i].cost != minCost_) {
+      uniformCost_ = false;
+      minCost_ = std::min(minCost_, nodes_[i].cost);
+    }
+  }
+
+  std::pmr::vector<uint8_t> flags(n, memory);
+  for (std::size_t i = 0; i < n; ++i) flags[i] = nodes_[i].walkable ? 0xFF : 0x00;
+  walkBits_.assign((n + 63) / 64, 0);
+  simd::packFlags(flags.data(), n, walkBits_.data());
+  neighborMask_.assign(n, 0);
+  buildNeighborMasks(flags.data(), width_, height_, neighborMask_.data());
 }
 
 NodeCount GridGraph::getNodeCount() const { return static_cast<NodeCount>(nodes_.size()); }
@@ -42,28 +122,29 @@ void GridGraph::getNeighbors(NodeId id, std::vector<Edge>& out) const {
     return;
   }
 
-  const Point p = nodes_[id].position;
-  const int x = p.x;
-  const int y = p.y;
-
-  // 8-direction offsets
-  static constexpr int offs[8][2] = {{1,0},{-1,0},{0,1},{0,-1},{1,1},{1,-1},{-1,1},{-1,-1}};
-
-  for (int i = 0; i < 8; ++i) {
-    int nx = x + offs[i][0];
-    int ny = y + offs[i][1];
-    if (nx < 0 || ny < 0) continue;
-    if (nx >= width_ || ny >= height_) continue;
-    NodeId nid = static_cast<NodeId>(ny * width_ + nx);
-    const Node& n = nodes_[nid];
-    if (!n.walkable) continue;
-    Cost c = n.cost;
-    // diagonal adjustment
-    if (std::abs(offs[i][0]) + std::abs(offs[i][1]) == 2) {
-      c *= static_cast<Cost>(std::sqrt(2.0)); // diagonal cost
-    }
-    out.push_back(Edge{nid, c});
+  const int stride = width_;
+  for (unsigned mask = neighborMask_[id]; mask != 0; mask &= mask - 1) {
+    const int d = __builtin_ctz(mask);
+    const NodeId nid = static_cast<NodeId>(static_cast<int>(id) + kOffsets[d][1] * stride + kOffsets[d][0]);
+    out.push_back(Edge{nid, enterCost_[2 * nid + (d >= kFirstDiagonal ? 1 : 0)]});
+  }
+}
+
+Cost GridGraph::getEdgeCost(NodeId from, NodeId to) const {
+  const Cost none = std::numeric_limits<Cost>::infinity();
+  if (from >= nodes_.size() || to >= nodes_.size()) return none;
+  // Narrower grids make the id difference ambiguous (width 2: +1 is east or south-west).
+  if (width_ < 3) return IGraph::getEdgeCost(from, to);
+  const long delta = static_cast<long>(to) - static_cast<long>(from);
+  const int dy = delta < -1 ? -1 : (delta > 1 ? 1 : 0);
+  const long dx = delta - static_cast<long>(dy) * width_;
+  if (dx < -1 || dx > 1 || (dx == 0 && dy == 0)) return none;
+  for (int d = 0; d < 8; ++d) {
+    if (kOffsets[d][0] != dx || kOffsets[d][1] != dy) continue;
+    if (!(neighborMask_[from] & (1u << d))) return none;
+    return enterCost_[2 * to + (d >= kFirstDiagonal ? 1 : 0)];
   }
+  return none;
 }
 
 Point GridGraph::getNodePosition(NodeId nodeId) const {
@@ -73,3 +154,83 @@ Point GridGraph::getNodePosition(NodeId nodeId) const {
   }
   return nodes_[nodeId].position;
 }
+
+bool GridGraph::lineOfSight(NodeId from, NodeId to) const {
+  if (from >= nodes_.size() || to >= nodes_.size()) return false;
+  int x = nodes_[from].position.x;
+  int y = nodes_[from].position.y;
+  const int x1 = nodes_[to].position.x;
+  const int y1 = nodes_[to].position.y;
+  const int dx = std::abs(x1 - x);
+  const int dy = std::abs(y1 - y);
+  const int sx = x1 > x ? 1 : -1;
+  const int sy = y1 > y ? 1 : -1;
+
+  // error tracks which cell border the segment crosses next: positive means a vertical border
+  // (step in x), negative a horizontal one (step in y), zero a corner (step both).
+  int error = dx - dy;
+  for (;;) {
+    if (!walkableAt(x, y)) return false;
+    if (x == x1 && y == y1) return true;
+    if (error > 0) {
+      x += sx;
+      error -= 2 * dy;
+    } else if (error < 0) {
+      y += sy;
+      error += 2 * dx;
+    } else {
+      if (!walkableAt(x + sx, y) || !walkableAt(x, y + sy)) return false;
+      x += sx;
+      y += sy;
+      error += 2 * (dx - dy);
+    }
+  }
+}
+
+bool GridGraph::isWalkable(NodeId nodeId) const {
+  return nodeId < nodes_.size() && nodes_[nodeId].walkable;
+}
+
+void GridGraph::setWalkable(NodeId nodeId, bool walkable) {
+  if (nodeId >= nodes_.size()) {
+    LOG_WARN("setWalkable: invalid nodeId=" + std::to_string(nodeId));
+    return;
+  }
+  if (nodes_[nodeId].walkable == walkable) return;
+  nodes_[nodeId].walkable = walkable;
+  if (walkable) walkBits_[nodeId >> 6] |= uint64_t{1} << (nodeId & 63);
+  else walkBits_[nodeId >> 6] &= ~(uint64_t{1} << (nodeId & 63));
+  updateNeighborMasks(nodeId);
+  if (walkable) {
+    // Only an opened cell can lower the minimum or break uniformity; a closed one leaves both as
+    // conservative bounds.
+    if (nodes_[nodeId].cost != minCost_) uniformCost_ = false;
+    minCost_ = std::min(minCost_, nodes_[nodeId].cost);
+  }
+  // A new wall may split a component, which union-find cannot undo; relabel on the next build.
+  // A removed wall joins the components around it.
+  if (walkable) components_.open(nodeId, walkBits_.data());
+  else components_.invalidate();
+}
+
+void GridGraph::updateNeighborMasks(NodeId nodeId) {
+  const Point p = nodes_[nodeId].position;
+  const bool walkable = nodes_[nodeId].walkable;
+  for (int d = 0; d < 8; ++d) {
+    // The neighbour at offset d sees this cell at the opposite offset.
+    const int nx = p.x + kOffsets[d][0];
+    const int ny = p.y + kOffsets[d][1];
+    if (nx < 0 || ny < 0 || nx >= width_ || ny >= height_) continue;
+    uint8_t& mask = neighborMask_[static_cast<std::size_t>(ny * width_ + nx)];
+    const uint8_t bit = static_cast<uint8_t>(1u << kOpposite[d]);
+    mask = static_cast<uint8_t>(walkable ? (mask | bit) : (mask & ~bit));
+  }
+}
+
+void GridGraph::buildComponents(unsigned maxThreads) {
+  if (!components_.valid()) components_.build(width_, height_, walkBits_.data(), maxThreads);
+}
+
+bool GridGraph::sameComponent(NodeId a, NodeId b, bool allowDiagonal) const {
+  return components_.sameComponent(a, b, allowDiagonal);
+}
@@ -4,13 +4,19 @@
  *------------------------------------------------------------------------------------------------*/
 
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <vector>
 #include <cstdlib>
 #include <string>
 
 #include "algorithms/IDAStar.hh"
+#include "algorithms/VisitRecorder.hh"
+#include "algorithms/SearchBudget.hh"
+#include "algorithms/StatsRecorder.hh"
 #include "utils/Logger.hh"
 
 namespace {
@@ -46,74 +52,121 @@ bool violatesCornerRule(const IGraph& graph, NodeId u, NodeId v, const std::vect
   return !(hasP1 && hasP2);
 }
 
-struct SearchState {
-  const IGraph& graph;
-  const IHeuristic& heuristic;
-  const AlgorithmConfig& config;
-  NodeId goal;
-  std::vector<bool> inPath;
-  std::vector<NodeId> currentPath;
-  std::vector<NodeId> bestPath;
-  std::vector<NodeId> visitedOrder;
+struct Child {
+  NodeId id;
+  Cost cost;
+  Cost h;
 };
 
-Cost dfs(SearchState& state, NodeId node, Cost g, Cost threshold, Cost& bestOverrun) {
-  const IGraph& graph = state.graph;
-  const IHeuristic& h = state.heuristic;
-  const AlgorithmConfig& config = state.config;
-
-  Cost f = g + h.compute(node, state.goal);
-  if (f > threshold) {
-    if (f < bestOverrun) bestOverrun = f;
-    return f;
-  }
+// One node on the explicit DFS stack. Its children, sorted by f, live in
+// children[childBegin, childEnd) of the shared child buffer.
+struct Frame {
+  NodeId node;
+  Cost g;
+  std::size_t childBegin;
+  std::size_t childEnd;
+  std::size_t next;
+};
 
-  if (node == state.goal) {
-    state.bestPath = state.currentPath;
-    return f;
-  }
+// Direct-mapped table of the smallest g each node was reached with in the current iteration. A node
+// reached again with a g that is no smaller has nothing new below it under the same threshold.
+class TranspositionTable {
+
+  private:
+    struct Entry {
+      NodeId node;
+      uint32_t iteration;
+      Cost g;
+    };
+
+    std::vector<Entry> entries_;
+    std::size_t mask_ = 0;
+
+  public:
+    TranspositionTable(std::size_t capacity, NodeCount nodeCount) {
+      if (capacity == 0) return;
+      std::size_t size = 1;
+      while (size * 2 <= capacity && size < nodeCount) size *= 2;
+      entries_.assign(size, Entry{static_cast<NodeId>(-1), 0, 0.0});
+      mask_ = size - 1;
+    }
 
-  std::vector<Edge> neighbors;
-  graph.getNeighbors(node, neighbors);
+    bool prune(NodeId node, Cost g, uint32_t iteration) {
+      if (entries_.empty()) return false;
+      Entry& e = entries_[(static_cast<std::size_t>(node) * 2654435761u) & mask_];
+      if (e.node == node && e.iteration == iteration && e.g <= g) return true;
+      e = Entry{node, iteration, g};
+      return false;
+    }
 
-  for (const Edge& e : neighbors) {
-    NodeId v = e.id;
+    std::size_t bytes() const { return StatsRecorder::bytes(entries_); }
+};
 
-    if (!config.allowDiagonal && isDiagonalMove(graph, node, v)) {
-      continue;
+// Each threshold is raised to admit about this many times the nodes the last iteration expanded
+// (IDA*_CR), so the number of iterations grows with the log of the search size instead of with the
+// number of distinct f values.
+constexpr double kGrowth = 2.0;
+
+// Relative gap under which two path costs are the same cost summed in a different order.
+constexpr Cost kSameCost = 1e-9;
+
+// The f values an iteration cut off, bucketed by how far they overran its threshold, so the next
+// threshold can be chosen to admit a given number of them. Buckets cover overruns up to the
+// threshold itself (f up to twice the threshold); the last one also takes everything beyond.
+class OverrunHistogram {
+
+  private:
+    static constexpr std::size_t kBuckets = 64;
+
+    std::array<std::size_t, kBuckets> counts_{};
+    Cost base_ = 0.0;
+    Cost width_ = 1.0;
+    Cost min_ = std::numeric_limits<Cost>::infinity();
+    Cost max_ = 0.0;
+
+  public:
+    void reset(Cost threshold) {
+      counts_.fill(0);
+      base_ = threshold;
+      width_ = std::max<Cost>(threshold, 1.0) / kBuckets;
+      min_ = std::numeric_limits<Cost>::infinity();
+      max_ = 0.0;
     }
-    if (config.allowDiagonal && config.dontCrossCorners && isDiagonalMove(graph, node, v) &&
-        violatesCornerRule(graph, node, v, neighbors)) {
-      continue;
+
+    void add(Cost f) {
+      min_ = std::min(min_, f);
+      max_ = std::max(max_, f);
+      const Cost bucket = (f - base_) / width_;
+      ++counts_[bucket < static_cast<Cost>(kBuckets - 1) ? static_cast<std::size_t>(bucket) : kBuckets - 1];
     }
 
-    if (state.inPath[v]) continue; // avoid cycles on current path
+    bool empty() const { return min_ == std::numeric_limits<Cost>::infinity(); }
 
-    state.inPath[v] = true;
-    state.currentPath.push_back(v);
-    state.visitedOrder.push_back(v);
+    // The smallest f cut off: no path is cheaper than this once the iteration is complete.
+    Cost min() const { return min_; }
 
-    Cost t = dfs(state, v, g + e.cost, threshold, bestOverrun);
-    if (!state.bestPath.empty() && state.bestPath.back() == state.goal) {
-      return t; // goal found, unwind
+    // The lowest bucket edge that admits at least `target` of the cut-off values, and never less
+    // than min() so that every iteration makes progress.
+    Cost threshold(double target) const {
+      double admitted = 0.0;
+      for (std::size_t b = 0; b + 1 < kBuckets; ++b) {
+        admitted += static_cast<double>(counts_[b]);
+        if (admitted >= target) return std::max(min_, base_ + width_ * static_cast<Cost>(b + 1));
+      }
+      return max_;
     }
-
-    state.currentPath.pop_back();
-    state.inPath[v] = false;
-  }
-
-  return bestOverrun;
-}
+};
 
 } // namespace
 
 Result IDAStar::findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) {
-  Result res;
+  Result res(config.resultMemory);
   res.success = false;
   res.cost = 0.0;
   res.time = Time::zero();
 
   const auto t0 = std::chrono::steady_clock::now();
+  StatsRecorder stats(res);
 
   LOG_INFO(std::string("IDA*: start from=") + std::to_string(start) + " to=" + std::to_string(goal));
 
@@ -131,63 +184,169 @@ Result IDAStar::findPath(const IGraph& graph, NodeId start, NodeId goal, const A
     return res;
   }
 
-  SearchState state{
-      graph,
-      h,
-      config,
-      goal,
-      std::vector<bool>(n, false),
-      {},
-      {},
-      {}
-  };
+  VisitRecorder recorder(res, config, n);
+  SearchBudget budget(config, start, goal);
+  TranspositionTable table(config.transpositionTableSize, n);
+  const Cost INF = std::numeric_limits<Cost>::infinity();
 
-  state.inPath[start] = true;
-  state.currentPath.push_back(start);
-  state.visitedOrder.push_back(start);
+  // Buffers are reused across iterations, so the search stops allocating once they have grown to
+  // the deepest path explored.
+  std::vector<Frame> stack;
+  std::vector<Child> children;
+  std::vector<Edge> neighbors;
+  std::vector<bool> inPath(n, false);
+  // Copy of the stack taken whenever the budget's closest node changes; returned if the search is
+  // interrupted.
+  std::vector<NodeId> partialPath{start};
+  NodeId partialEnd = start;
+  Cost partialCost = 0.0;
 
   Cost threshold = h.compute(start, goal);
-  const Cost INF = std::numeric_limits<Cost>::infinity();
+  stats.heuristicCall();
+  // No path costs less than lowerBound: h(start) at first, then the smallest f the last complete
+  // iteration cut off.
+  Cost lowerBound = threshold;
+  OverrunHistogram overruns;
+  std::size_t iterationExpansions = 0;
+  // Best solution so far. Thresholds can overshoot the optimal cost, so a goal reached in an
+  // iteration is kept and the rest of the iteration only looks for cheaper ones.
+  std::vector<NodeId> bestPath;
+  Cost bestCost = INF;
+  uint32_t iteration = 0;
+  bool proven = false;
+  bool stopped = false;
+
+  // Tries to push node onto the stack; returns without pushing if the threshold, the transposition
+  // table or the budget cuts it off. The goal is never pushed: reaching it records a solution.
+  const auto enter = [&](NodeId node, Cost g, Cost hv) {
+    const Cost f = g + hv;
+    if (f > threshold) {
+      if (bestCost == INF) overruns.add(f);
+      return;
+    }
+    if (node == goal) {
+      recorder.record(node);
+      bestPath.clear();
+      for (const Frame& fr : stack) bestPath.push_back(fr.node);
+      bestPath.push_back(node);
+      bestCost = g;
+      // Only strictly cheaper solutions from here on; none can beat the lower bound.
+      threshold = bestCost * (1.0 - kSameCost);
+      proven = bestCost <= lowerBound * (1.0 + kSameCost);
+      return;
+    }
+    if (table.prune(node, g, iteration)) return;
+    stopped = budget.exhausted(node);
+    if (budget.limited() && budget.closest() == node && node != partialEnd) {
+      partialPath.clear();
+      for (const Frame& fr : stack) partialPath.push_back(fr.node);
+      partialPath.push_back(node);
+      partialEnd = node;
+      partialCost = g;
+    }
+    if (stopped) return;
+
+    recorder.record(node);
+    stats.expanded();
+    ++iterationExpansions;
+    inPath[node] = true;
+    const std::size_t childBegin = children.size();
+    graph.getNeighbors(node, neighbors);
+    for (const Edge& e : neighbors) {
+      if (!config.allowDiagonal && isDiagonalMove(graph, node, e.id)) {
+        continue;
+      }
+      if (config.allowDiagonal && config.dontCrossCorners && isDiagonalMove(graph, node, e.id) &&
+          violatesCornerRule(graph, node, e.id, neighbors)) {
+        continue;
+      }
+      if (inPath[e.id]) continue; // avoid cycles on current path
+      children.push_back(Child{e.id, e.cost, h.compute(e.id, goal)});
+      stats.generated();
+      stats.heuristicCall();
+    }
+    // Most promising child first, so a cheap solution is met early and tightens the threshold.
+    std::sort(children.begin() + static_cast<std::ptrdiff_t>(childBegin), children.end(),
+              [](const Child& a, const Child& b) { return a.cost + a.h < b.cost + b.h; });
+    stack.push_back(Frame{node, g, childBegin, children.size(), childBegin});
+    stats.pushed(stack.size());
+  };
+
+  const auto recordWorkspace = [&]() {
+    stats.workspace(StatsRecorder::bytes(stack) + StatsRecorder::bytes(children) + StatsRecorder::bytes(neighbors) +
+                    StatsRecorder::bytes(inPath) + StatsRecorder::bytes(partialPath) +
+                    StatsRecorder::bytes(bestPath) + table.bytes());
+  };
+  stats.endSetup();
 
   while (true) {
-    Cost bestOverrun = INF;
-    Cost t = dfs(state, start, 0.0, threshold, bestOverrun);
-
-    if (!state.bestPath.empty() && state.bestPath.back() == goal) {
-      // reconstruct result
-      res.path = state.bestPath;
-
-      // cost: sum edge costs
-      Cost total = 0.0;
-      for (std::size_t i = 1; i < res.path.size(); ++i) {
-        std::vector<Edge> tmp;
-        graph.getNeighbors(res.path[i - 1], tmp);
-        for (const Edge& e : tmp) {
-          if (e.id == res.path[i]) {
-            total += e.cost;
-            break;
-          }
-        }
+    ++iteration;
+    overruns.reset(threshold);
+    iterationExpansions = 0;
+    enter(start, 0.0, threshold);
+
+    while (!proven && !stopped && !stack.empty()) {
+      Frame& top = stack.back();
+      if (top.next == top.childEnd) {
+        inPath[top.node] = false;
+        children.resize(top.childBegin);
+        stack.pop_back();
+        stats.popped();
+        continue;
       }
-
-      res.cost = total;
-      res.visited = state.visitedOrder;
+      const Child child = children[top.next++];
+      if (inPath[child.id]) continue;
+      enter(child.id, top.g + child.cost, child.h);
+    }
+    for (const Frame& fr : stack) inPath[fr.node] = false;
+    stack.clear();
+    children.clear();
+
+    // A complete iteration leaves no path cheaper than its solution unexplored. An interrupted one
+    // still returns its solution, with the bound the last complete iteration proved.
+    if (bestCost != INF) {
+      stats.endSearch();
+      recorder.flush();
+      recordWorkspace();
+      res.path.assign(bestPath.begin(), bestPath.end());
+      res.cost = bestCost;
+      stats.endReconstruct();
+      if (stopped && !proven) res.suboptimalityBound = lowerBound > 0.0 ? std::max<Cost>(1.0, bestCost / lowerBound) : INF;
       res.success = true;
+      res.status = SearchStatus::SUCCESS;
       res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
-      LOG_INFO(std::string("IDA*: success cost=") + std::to_string(res.cost));
+      LOG_INFO(std::string("IDA*: success cost=") + std::to_string(res.cost) + " iterations=" + std::to_string(iteration));
       return res;
     }
 
-    if (bestOverrun == INF || bestOverrun <= threshold) {
-      // No solution within any higher threshold
+    if (stopped) {
+      // An interrupted search returns the path to the node closest to the goal. Every frame carries
+      // its g, so the cost needs no walk over the path's edges.
+      stats.endSearch();
+      recorder.flush();
+      recordWorkspace();
+      res.path.assign(partialPath.begin(), partialPath.end());
+      res.cost = partialCost;
+      stats.endReconstruct();
+      res.status = budget.status();
+      res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+      LOG_WARN(std::string("IDA*: stopped, partial cost=") + std::to_string(res.cost));
+      return res;
+    }
+
+    if (overruns.empty()) {
+      // Nothing was cut off, so no higher threshold can reach the goal.
+      stats.endSearch();
+      recorder.flush();
+      recordWorkspace();
       res.success = false;
-      res.visited = state.visitedOrder;
+      res.status = SearchStatus::NO_PATH;
       res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
       LOG_WARN("IDA*: no path found");
       return res;
     }
 
-    threshold = bestOverrun;
+    lowerBound = overruns.min();
+    threshold = overruns.threshold((kGrowth - 1.0) * static_cast<double>(std::max<std::size_t>(iterationExpansions, 1)));
   }
 }
-
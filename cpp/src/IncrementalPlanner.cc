@@ -0,0 +1,61 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include "api/IncrementalPlanner.hh"
+
+#include "factories/HeuristicFactory.hh"
+#include "utils/Logger.hh"
+
+IncrementalPlanner::IncrementalPlanner(
+    const uint8_t* grid,
+    std::size_t gridSize,
+    int width,
+    int height,
+    int startIndex,
+    int goalIndex,
+    const EngineOptions& options)
+    : nodeCount_(0) {
+  graph_ = PathfindingEngine::buildGraph(grid, gridSize, width, height, options.terrain);
+  nodeCount_ = graph_->getNodeCount();
+
+  AlgorithmConfig cfg;
+  cfg.heuristic = HeuristicFactory::createHeuristic(options.heuristic, graph_);
+  cfg.allowDiagonal = options.allowDiagonal;
+  cfg.dontCrossCorners = options.dontCrossCorners;
+  cfg.recording = options.recording;
+  cfg.recordingSampleRate = options.recordingSampleRate;
+  cfg.onVisited = options.onVisited;
+  cfg.visitChunkSize = options.visitChunkSize;
+
+  planner_ = std::make_unique<DStarLite>(*graph_, cfg, static_cast<NodeId>(startIndex), static_cast<NodeId>(goalIndex));
+}
+
+void IncrementalPlanner::setStart(int index) {
+  if (index < 0 || static_cast<NodeCount>(index) >= nodeCount_) {
+    LOG_WARN("IncrementalPlanner: invalid start=" + std::to_string(index));
+    return;
+  }
+  planner_->setStart(static_cast<NodeId>(index));
+}
+
+void IncrementalPlanner::setGoal(int index) {
+  if (index < 0 || static_cast<NodeCount>(index) >= nodeCount_) {
+    LOG_WARN("IncrementalPlanner: invalid goal=" + std::to_string(index));
+    return;
+  }
+  planner_->setGoal(static_cast<NodeId>(index));
+}
+
+void IncrementalPlanner::setCell(int index, bool blocked) {
+  if (index < 0) {
+    LOG_WARN("IncrementalPlanner: invalid cell=" + std::to_string(index));
+    return;
+  }
+  planner_->setCell(static_cast<NodeId>(index), blocked);
+}
+
+Result IncrementalPlanner::replan() {
+  return planner_->replan();
+}
@@ -0,0 +1,61 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include "api/LabelCache.hh"
+
+#include <vector>
+
+std::shared_ptr<const ComponentLabels> LabelCache::label(
+    const uint8_t* grid, std::size_t gridSize, int width, int height, const TerrainCosts& terrain) {
+  if (width <= 0 || height <= 0) return nullptr;
+
+  // Walkable as the engine's graph sees it: open in the grid and not blocked by the terrain.
+  const std::size_t n = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+  std::vector<uint64_t> walkBits((n + 63) / 64, 0);
+  for (std::size_t i = 0; i < n && i < gridSize; ++i) {
+    if (grid[i] == 0 && (terrain.empty() || terrain.at(i) > 0.0)) walkBits[i >> 6] |= uint64_t{1} << (i & 63);
+  }
+  auto labels = std::make_shared<ComponentLabels>();
+  labels->build(width, height, walkBits.data());
+  return labels;
+}
+
+std::shared_ptr<const ComponentLabels> LabelCache::labelsFor(
+    const uint8_t* grid, std::size_t gridSize, int width, int height, const TerrainCosts& terrain,
+    uint64_t mapVersion) {
+  const auto matches = [&](const Entry& e) {
+    return e.mapVersion == mapVersion && e.width == width && e.height == height;
+  };
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (!matches(*it)) continue;
+      entries_.splice(entries_.begin(), entries_, it);
+      return it->labels;
+    }
+  }
+
+  std::shared_ptr<const ComponentLabels> labels = label(grid, gridSize, width, height, terrain);
+  if (!labels) return nullptr;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const Entry& e : entries_) {
+    if (matches(e)) return e.labels;
+  }
+  entries_.remove_if([mapVersion](const Entry& e) { return e.mapVersion == mapVersion; });
+  entries_.push_front(Entry{mapVersion, width, height, labels});
+  if (entries_.size() > kVersions) entries_.pop_back();
+  return labels;
+}
+
+void LabelCache::drop(uint64_t mapVersion) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.remove_if([mapVersion](const Entry& e) { return e.mapVersion == mapVersion; });
+}
+
+void LabelCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+}
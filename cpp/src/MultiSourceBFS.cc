@@ -0,0 +1,264 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include "algorithms/MultiSourceBFS.hh"
+#include "simd/Simd.hh"
+#include "utils/Logger.hh"
+
+namespace {
+
+constexpr std::size_t kWordBits = 64;
+constexpr std::size_t kNoColumn = static_cast<std::size_t>(-1);
+constexpr std::size_t kTransposeTile = 64;
+
+// The moves BFS takes out of every node, in CSR form: the successors of u are
+// targets[offsets[u], offsets[u + 1]). Built once per call, as a node is expanded at every level
+// some lane reaches it.
+struct Moves {
+  std::vector<std::size_t> offsets;
+  std::vector<NodeId> targets;
+};
+
+Moves buildMoves(const IGraph& graph, bool allowDiagonal, bool dontCrossCorners) {
+  const NodeCount n = graph.getNodeCount();
+  // On grids wide enough for an id difference to name the direction (see ParentMap), the move
+  // and the two cells beside its corner follow from ids alone.
+  const long stride = graph.getGridStride() >= 3 ? graph.getGridStride() : 0;
+  Moves moves;
+  moves.offsets.reserve(static_cast<std::size_t>(n) + 1);
+  moves.offsets.push_back(0);
+  std::vector<Edge> neighbors;
+  const auto isNeighbor = [&neighbors](long id) {
+    return std::any_of(neighbors.begin(), neighbors.end(), [id](const Edge& e) { return static_cast<long>(e.id) == id; });
+  };
+  for (NodeId u = 0; u < n; ++u) {
+    graph.getNeighbors(u, neighbors);
+    const Point pu = stride ? Point{} : graph.getNodePosition(u);
+    for (const Edge& e : neighbors) {
+      bool diagonal = false;
+      long side1 = 0;
+      long side2 = 0;
+      if (stride) {
+        const long delta = static_cast<long>(e.id) - static_cast<long>(u);
+        const long dy = delta < -1 ? -1 : (delta > 1 ? 1 : 0);
+        const long dx = delta - dy * stride;
+        diagonal = dx != 0 && dy != 0;
+        side1 = static_cast<long>(u) + dx;
+        side2 = static_cast<long>(u) + dy * stride;
+      } else {
+        const Point pv = graph.getNodePosition(e.id);
+        diagonal = std::abs(pu.x - pv.x) == 1 && std::abs(pu.y - pv.y) == 1;
+      }
+      if (diagonal && !allowDiagonal) continue;
+      if (diagonal && dontCrossCorners) {
+        // Both cells beside the corner must be neighbours of u as well.
+        bool hasP1 = false;
+        bool hasP2 = false;
+        if (stride) {
+          hasP1 = isNeighbor(side1);
+          hasP2 = isNeighbor(side2);
+        } else {
+          const Point pv = graph.getNodePosition(e.id);
+          for (const Edge& f : neighbors) {
+            const Point pn = graph.getNodePosition(f.id);
+            if (pn.x == pv.x && pn.y == pu.y) hasP1 = true;
+            if (pn.x == pu.x && pn.y == pv.y) hasP2 = true;
+          }
+        }
+        if (!(hasP1 && hasP2)) continue;
+      }
+      moves.targets.push_back(e.id);
+    }
+    moves.offsets.push_back(moves.targets.size());
+  }
+  return moves;
+}
+
+// Adds the lanes of `from` missing from `known` to `to`, W words each. Returns whether `to` held
+// any lane before (bit 0) and whether any lane was added (bit 1). When W words fill whole
+// simd::Bytes registers (W = 2 or 4 on 128-bit backends, 4 on AVX2) they are merged a register at
+// a time; W = 1 stays on plain words.
+template <std::size_t W>
+unsigned mergeFresh(const uint64_t* from, const uint64_t* known, uint64_t* to) {
+  constexpr std::size_t kBytes = W * sizeof(uint64_t);
+  if constexpr (W > 1 && kBytes % simd::Bytes::kLanes == 0) {
+    const auto* const fromBytes = reinterpret_cast<const uint8_t*>(from);
+    const auto* const knownBytes = reinterpret_cast<const uint8_t*>(known);
+    auto* const toBytes = reinterpret_cast<uint8_t*>(to);
+    simd::Bytes before = simd::Bytes::splat(0);
+    simd::Bytes added = simd::Bytes::splat(0);
+    for (std::size_t b = 0; b < kBytes; b += simd::Bytes::kLanes) {
+      const simd::Bytes old = simd::Bytes::load(toBytes + b);
+      const simd::Bytes fresh = simd::Bytes::load(fromBytes + b).andNot(simd::Bytes::load(knownBytes + b));
+      (old | fresh).store(toBytes + b);
+      before = before | old;
+      added = added | fresh;
+    }
+    return (before.any() ? 1u : 0u) | (added.any() ? 2u : 0u);
+  } else {
+    uint64_t before = 0;
+    uint64_t added = 0;
+    for (std::size_t k = 0; k < W; ++k) {
+      const uint64_t fresh = from[k] & ~known[k];
+      before |= to[k];
+      to[k] |= fresh;
+      added |= fresh;
+    }
+    return (before != 0 ? 1u : 0u) | (added != 0 ? 2u : 0u);
+  }
+}
+
+// Runs the searches from sources[0, lanes) together, W words of lanes per cell. Lane i is bit
+// i % 64 of word i / 64. reach(v, word, bits, level) is told, level by level, which lanes got to v
+// first; returning false ends the traversal.
+template <std::size_t W, typename Reach>
+void traverse(const Moves& moves, const NodeId* sources, std::size_t lanes, Reach&& reach) {
+  const std::size_t n = moves.offsets.size() - 1;
+  // seen: lanes that reached the cell so far; visit: lanes whose frontier holds it at this level;
+  // next: lanes that reach it at the next one.
+  std::vector<uint64_t> seen(n * W, 0);
+  std::vector<uint64_t> visit(n * W, 0);
+  std::vector<uint64_t> next(n * W, 0);
+  std::vector<NodeId> frontier;
+  std::vector<NodeId> upcoming;
+
+  for (std::size_t lane = 0; lane < lanes; ++lane) {
+    const NodeId s = sources[lane];
+    if (s >= n) continue;
+    uint64_t* const cell = &visit[s * W];
+    if (std::all_of(cell, cell + W, [](uint64_t word) { return word == 0; })) frontier.push_back(s);
+    cell[lane / kWordBits] |= uint64_t{1} << (lane % kWordBits);
+  }
+  for (const NodeId s : frontier) {
+    for (std::size_t k = 0; k < W; ++k) {
+      seen[s * W + k] = visit[s * W + k];
+      if (visit[s * W + k] != 0 && !reach(s, k, visit[s * W + k], 0u)) return;
+    }
+  }
+
+  for (uint32_t level = 1; !frontier.empty(); ++level) {
+    upcoming.clear();
+    for (const NodeId u : frontier) {
+      const uint64_t* const from = &visit[u * W];
+      for (std::size_t m = moves.offsets[u]; m < moves.offsets[u + 1]; ++m) {
+        const NodeId v = moves.targets[m];
+        // First lanes to reach v at this level: v joins the next frontier.
+        if (mergeFresh<W>(from, &seen[v * W], &next[v * W]) == 2u) upcoming.push_back(v);
+      }
+    }
+
+    for (const NodeId u : frontier) std::fill_n(&visit[u * W], W, 0);
+    // Expanding in id order walks the grid row by row, so neighbouring words stay in cache.
+    std::sort(upcoming.begin(), upcoming.end());
+    for (const NodeId v : upcoming) {
+      for (std::size_t k = 0; k < W; ++k) {
+        seen[v * W + k] |= next[v * W + k];
+        if (next[v * W + k] != 0 && !reach(v, k, next[v * W + k], level)) return;
+      }
+    }
+    // The old frontier's words were just cleared, so visit is all zero again and serves as next.
+    visit.swap(next);
+    frontier.swap(upcoming);
+  }
+}
+
+// traverse() with as few words per cell as the batch needs.
+template <typename Reach>
+void runBatch(const Moves& moves, const NodeId* sources, std::size_t lanes, Reach&& reach) {
+  if (lanes <= kWordBits) traverse<1>(moves, sources, lanes, reach);
+  else if (lanes <= 2 * kWordBits) traverse<2>(moves, sources, lanes, reach);
+  else traverse<4>(moves, sources, lanes, reach);
+}
+
+} // namespace
+
+std::vector<uint32_t> MultiSourceBFS::distanceFields(
+    const IGraph& graph,
+    const std::vector<NodeId>& sources,
+    bool allowDiagonal,
+    bool dontCrossCorners) {
+  const std::size_t n = graph.getNodeCount();
+  LOG_INFO("MultiSourceBFS: distance fields of " + std::to_string(sources.size()) + " source(s) over " +
+           std::to_string(n) + " nodes");
+  std::vector<uint32_t> fields(sources.size() * n, kUnreachable);
+  if (sources.empty()) return fields;
+  const Moves moves = buildMoves(graph, allowDiagonal, dontCrossCorners);
+
+  // A level reaches a cell for many lanes at once, so the hop counts are first written cell by
+  // cell (byCell[v * lanes + lane], contiguous per cell) and then transposed into source rows a
+  // tile at a time, rather than scattered one row apart per lane.
+  std::vector<uint32_t> byCell;
+  for (std::size_t first = 0; first < sources.size(); first += kMaxLanes) {
+    const std::size_t lanes = std::min(kMaxLanes, sources.size() - first);
+    byCell.assign(n * lanes, kUnreachable);
+    runBatch(moves, sources.data() + first, lanes, [&](NodeId v, std::size_t word, uint64_t bits, uint32_t level) {
+      uint32_t* const cell = &byCell[v * lanes + word * kWordBits];
+      for (; bits != 0; bits &= bits - 1) cell[__builtin_ctzll(bits)] = level;
+      return true;
+    });
+    for (std::size_t v0 = 0; v0 < n; v0 += kTransposeTile) {
+      const std::size_t v1 = std::min(n, v0 + kTransposeTile);
+      for (std::size_t lane0 = 0; lane0 < lanes; lane0 += kTransposeTile) {
+        const std::size_t lane1 = std::min(lanes, lane0 + kTransposeTile);
+        for (std::size_t lane = lane0; lane < lane1; ++lane) {
+          uint32_t* const row = &fields[(first + lane) * n];
+          for (std::size_t v = v0; v < v1; ++v) row[v] = byCell[v * lanes + lane];
+        }
+      }
+    }
+  }
+  return fields;
+}
+
+std::vector<uint32_t> MultiSourceBFS::distanceMatrix(
+    const IGraph& graph,
+    const std::vector<NodeId>& sources,
+    const std::vector<NodeId>& targets,
+    bool allowDiagonal,
+    bool dontCrossCorners) {
+  const std::size_t n = graph.getNodeCount();
+  const std::size_t columns = targets.size();
+  LOG_INFO("MultiSourceBFS: " + std::to_string(sources.size()) + "x" + std::to_string(columns) + " hop matrix over " +
+           std::to_string(n) + " nodes");
+  std::vector<uint32_t> matrix(sources.size() * columns, kUnreachable);
+
+  // Columns of each target cell, as a list threaded through nextColumn (a cell may be listed twice).
+  std::vector<std::size_t> firstColumn(n, kNoColumn);
+  std::vector<std::size_t> nextColumn(columns, kNoColumn);
+  std::size_t validTargets = 0;
+  for (std::size_t t = columns; t-- > 0;) {
+    if (targets[t] >= n) continue;
+    nextColumn[t] = firstColumn[targets[t]];
+    firstColumn[targets[t]] = t;
+    ++validTargets;
+  }
+  if (validTargets == 0) return matrix;
+  const Moves moves = buildMoves(graph, allowDiagonal, dontCrossCorners);
+
+  for (std::size_t first = 0; first < sources.size(); first += kMaxLanes) {
+    const std::size_t lanes = std::min(kMaxLanes, sources.size() - first);
+    const auto valid = std::count_if(sources.begin() + static_cast<std::ptrdiff_t>(first),
+                                     sources.begin() + static_cast<std::ptrdiff_t>(first + lanes),
+                                     [n](NodeId s) { return s < n; });
+    // (source, target) pairs still to be reached by this batch.
+    std::size_t remaining = static_cast<std::size_t>(valid) * validTargets;
+    if (remaining == 0) continue;
+    runBatch(moves, sources.data() + first, lanes, [&](NodeId v, std::size_t word, uint64_t bits, uint32_t level) {
+      for (std::size_t t = firstColumn[v]; t != kNoColumn; t = nextColumn[t]) {
+        for (uint64_t rest = bits; rest != 0; rest &= rest - 1) {
+          const std::size_t s = first + word * kWordBits + static_cast<std::size_t>(__builtin_ctzll(rest));
+          matrix[s * columns + t] = level;
+          --remaining;
+        }
+      }
+      return remaining != 0;
+    });
+  }
+  return matrix;
+}
@@ -5,6 +5,7 @@
 
 #include <cmath>
 #include "heuristics/Octile.hh"
+#include "heuristics/DistanceBatch.hh"
 #include "utils/Logger.hh"
 
 Cost Octile::compute(NodeId from, NodeId to) const {
@@ -13,6 +14,14 @@ Cost Octile::compute(NodeId from, NodeId to) const {
   double dx = std::abs(a.x - b.x);
   double dy = std::abs(a.y - b.y);
   double F = std::sqrt(2.0) - 1.0;
-  Cost v = static_cast<Cost>((dx < dy) ? (dx * F + dy) : (dy * F + dx));
+  Cost v = scale_ * static_cast<Cost>((dx < dy) ? (dx * F + dy) : (dy * F + dx));
   return v;
 }
+
+void Octile::computeBatch(const NodeId* from, std::size_t count, NodeId to, Cost* out) const {
+  const simd::Doubles f = simd::Doubles::splat(std::sqrt(2.0) - 1.0);
+  const simd::Doubles scale = simd::Doubles::splat(scale_);
+  computeDistanceBatch(*graph_, from, count, to, out, [&](simd::Doubles dx, simd::Doubles dy) {
+    return scale * (min(dx, dy) * f + max(dx, dy));
+  });
+}
@@ -0,0 +1,271 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+#include "graph/PagedGridGraph.hh"
+#include "utils/Logger.hh"
+
+namespace {
+
+constexpr char kMagic[4] = {'P', 'F', 'T', 'G'};
+constexpr uint32_t kVersion = 1;
+constexpr std::streamoff kHeaderBytes = 4 + 4 * sizeof(uint32_t);
+
+// Largest tile side: a 1 GiB tile. Bounds what one readTile() may allocate whatever the header says.
+constexpr uint32_t kMaxTileSize = 1u << 15;
+
+// Keep a 2x2 block of tiles resident: a cell's neighbors never span more than that.
+constexpr std::size_t kMinResidentTiles = 4;
+
+// Prefetches in flight at once; more would only compete with demand loads for the disk.
+constexpr std::size_t kMaxPendingTiles = 2;
+
+int sign(int v) { return (v > 0) - (v < 0); }
+
+} // namespace
+
+PagedGridGraph::PagedGridGraph(const std::string& path, std::size_t memoryBudget)
+    : path_(path), width_(0), height_(0), tileSize_(0), tilesX_(0), tilesY_(0), maxResidentTiles_(0) {
+  std::ifstream in(path_, std::ios::binary);
+  if (!in) {
+    LOG_ERROR("PagedGridGraph ctor: cannot open " + path_);
+    throw std::runtime_error("cannot open tiled map " + path_);
+  }
+
+  char magic[4];
+  uint32_t header[4];
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || header[0] != kVersion) {
+    LOG_ERROR("PagedGridGraph ctor: invalid header in " + path_);
+    throw std::runtime_error("invalid tiled map header in " + path_);
+  }
+
+  const uint64_t cells = static_cast<uint64_t>(header[1]) * header[2];
+  if (header[1] == 0 || header[2] == 0 || header[3] == 0 || header[3] > kMaxTileSize ||
+      cells > std::numeric_limits<NodeId>::max() || header[1] > static_cast<uint32_t>(std::numeric_limits<int>::max()) ||
+      header[2] > static_cast<uint32_t>(std::numeric_limits<int>::max())) {
+    LOG_ERROR("PagedGridGraph ctor: unsupported dimensions in " + path_);
+    throw std::runtime_error("unsupported tiled map dimensions in " + path_);
+  }
+
+  width_ = static_cast<int>(header[1]);
+  height_ = static_cast<int>(header[2]);
+  tileSize_ = static_cast<int>(header[3]);
+  tilesX_ = (width_ + tileSize_ - 1) / tileSize_;
+  tilesY_ = (height_ + tileSize_ - 1) / tileSize_;
+
+  const std::size_t tileBytes = static_cast<std::size_t>(tileSize_) * static_cast<std::size_t>(tileSize_);
+
+  // Every tile must be on disk: readTile() runs inside getNeighbors(), in the middle of a search,
+  // so a truncated file is rejected here rather than there.
+  const uint64_t expected = static_cast<uint64_t>(kHeaderBytes) +
+                            static_cast<uint64_t>(tilesX_) * static_cast<uint64_t>(tilesY_) * tileBytes;
+  in.seekg(0, std::ios::end);
+  const std::streamoff length = in.tellg();
+  if (length < 0 || static_cast<uint64_t>(length) != expected) {
+    LOG_ERROR("PagedGridGraph ctor: " + path_ + " holds " + std::to_string(length) + " bytes, expected " +
+              std::to_string(expected));
+    throw std::runtime_error("truncated or corrupt tiled map " + path_);
+  }
+
+  maxResidentTiles_ = std::max(kMinResidentTiles, memoryBudget / tileBytes);
+
+  LOG_INFO("PagedGridGraph ctor: width=" + std::to_string(width_) + " height=" + std::to_string(height_) +
+           " tileSize=" + std::to_string(tileSize_) + " maxResidentTiles=" + std::to_string(maxResidentTiles_));
+}
+
+PagedGridGraph::~PagedGridGraph() {
+  std::lock_guard<std::mutex> lk(mutex_);
+  for (auto& p : pending_) {
+    if (p.second.valid()) p.second.wait();
+  }
+}
+
+void PagedGridGraph::writeTiledMap(const std::string& path, int width, int height, int tileSize,
+                                   const std::vector<uint8_t>& grid) {
+  if (width <= 0 || height <= 0 || tileSize <= 0 || static_cast<uint32_t>(tileSize) > kMaxTileSize ||
+      grid.size() != static_cast<std::size_t>(width) * static_cast<std::size_t>(height)) {
+    LOG_ERROR("PagedGridGraph::writeTiledMap: invalid tileSize or grid.size() does not match width*height");
+    throw std::invalid_argument("invalid tileSize or grid.size() does not match width*height");
+  }
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    LOG_ERROR("PagedGridGraph::writeTiledMap: cannot open " + path);
+    throw std::runtime_error("cannot write tiled map " + path);
+  }
+
+  const uint32_t header[4] = {kVersion, static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+                              static_cast<uint32_t>(tileSize)};
+  out.write(kMagic, sizeof(kMagic));
+  out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+  const int tilesX = (width + tileSize - 1) / tileSize;
+  const int tilesY = (height + tileSize - 1) / tileSize;
+  std::vector<uint8_t> tile(static_cast<std::size_t>(tileSize) * static_cast<std::size_t>(tileSize));
+
+  for (int ty = 0; ty < tilesY; ++ty) {
+    for (int tx = 0; tx < tilesX; ++tx) {
+      std::fill(tile.begin(), tile.end(), static_cast<uint8_t>(1));
+      for (int cy = 0; cy < tileSize; ++cy) {
+        const int y = ty * tileSize + cy;
+        if (y >= height) break;
+        const int x0 = tx * tileSize;
+        const int count = std::min(tileSize, width - x0);
+        const std::size_t src = static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x0);
+        std::copy_n(grid.begin() + static_cast<std::ptrdiff_t>(src), count,
+                    tile.begin() + static_cast<std::ptrdiff_t>(cy) * tileSize);
+      }
+      out.write(reinterpret_cast<const char*>(tile.data()), static_cast<std::streamsize>(tile.size()));
+    }
+  }
+
+  if (!out) {
+    LOG_ERROR("PagedGridGraph::writeTiledMap: write failed for " + path);
+    throw std::runtime_error("write failed for tiled map " + path);
+  }
+}
+
+// Each read opens its own stream so background prefetches never share file state with demand loads.
+std::vector<uint8_t> PagedGridGraph::readTile(int tile) const {
+  const std::size_t tileBytes = static_cast<std::size_t>(tileSize_) * static_cast<std::size_t>(tileSize_);
+  std::vector<uint8_t> cells(tileBytes);
+
+  std::ifstream in(path_, std::ios::binary);
+  in.seekg(kHeaderBytes + static_cast<std::streamoff>(tile) * static_cast<std::streamoff>(tileBytes));
+  in.read(reinterpret_cast<char*>(cells.data()), static_cast<std::streamsize>(tileBytes));
+  if (!in) {
+    LOG_ERROR("PagedGridGraph: failed to read tile " + std::to_string(tile) + " from " + path_);
+    throw std::runtime_error("failed to read tile from " + path_);
+  }
+  return cells;
+}
+
+// Caller must hold mutex_.
+const uint8_t* PagedGridGraph::acquireTile(int tile) const {
+  if (tile == lastTile_) return lastCells_;
+
+  auto it = tiles_.find(tile);
+  if (it != tiles_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+  } else {
+    std::vector<uint8_t> cells;
+    auto p = pending_.find(tile);
+    if (p != pending_.end()) {
+      cells = p->second.get();
+      pending_.erase(p);
+    } else {
+      cells = readTile(tile);
+      ++tileLoads_;
+    }
+    lru_.push_front(tile);
+    it = tiles_.emplace(tile, Tile{std::move(cells), lru_.begin()}).first;
+    evictIfNeeded();
+  }
+
+  if (lastTile_ != -1) prefetchAlong(lastTile_, tile);
+  lastTile_ = tile;
+  lastCells_ = it->second.cells.data();
+  return lastCells_;
+}
+
+// Caller must hold mutex_. Crossing from one tile into another tells us which way the frontier is
+// heading; the tile one step further in that direction is read in the background.
+void PagedGridGraph::prefetchAlong(int from, int to) const {
+  const int dx = sign(to % tilesX_ - from % tilesX_);
+  const int dy = sign(to / tilesX_ - from / tilesX_);
+  if (dx == 0 && dy == 0) return;
+
+  const int nx = to % tilesX_ + dx;
+  const int ny = to / tilesX_ + dy;
+  if (nx < 0 || ny < 0 || nx >= tilesX_ || ny >= tilesY_) return;
+
+  const int next = ny * tilesX_ + nx;
+  if (tiles_.count(next) || pending_.count(next) || pending_.size() >= kMaxPendingTiles) return;
+
+  try {
+    pending_.emplace(next, std::async(std::launch::async, [this, next] { return readTile(next); }));
+    ++tileLoads_;
+    evictIfNeeded();
+  } catch (const std::system_error&) {
+    // No threads available (e.g. single-threaded WASM): the tile is simply loaded on demand.
+  }
+}
+
+// Caller must hold mutex_. Pending prefetches count against the budget but are never dropped.
+void PagedGridGraph::evictIfNeeded() const {
+  while (tiles_.size() + pending_.size() > maxResidentTiles_ && tiles_.size() > 1) {
+    const int victim = lru_.back();
+    lru_.pop_back();
+    tiles_.erase(victim);
+    if (victim == lastTile_) {
+      lastTile_ = -1;
+      lastCells_ = nullptr;
+    }
+  }
+}
+
+// Caller must hold mutex_.
+bool PagedGridGraph::walkableAt(int x, int y) const {
+  const int tile = (y / tileSize_) * tilesX_ + (x / tileSize_);
+  const uint8_t* cells = acquireTile(tile);
+  return cells[(y % tileSize_) * tileSize_ + (x % tileSize_)] == 0;
+}
+
+NodeCount PagedGridGraph::getNodeCount() const {
+  return static_cast<NodeCount>(width_) * static_cast<NodeCount>(height_);
+}
+
+void PagedGridGraph::getNeighbors(NodeId id, std::vector<Edge>& out) const {
+  out.clear();
+  if (id >= getNodeCount()) {
+    LOG_WARN("PagedGridGraph::getNeighbors: invalid node id=" + std::to_string(id));
+    return;
+  }
+
+  const int x = static_cast<int>(id % static_cast<NodeId>(width_));
+  const int y = static_cast<int>(id / static_cast<NodeId>(width_));
+
+  // Same 8-direction order and costs as GridGraph so results match on identical maps.
+  static constexpr int offs[8][2] = {{1,0},{-1,0},{0,1},{0,-1},{1,1},{1,-1},{-1,1},{-1,-1}};
+  static const Cost diagonal = static_cast<Cost>(std::sqrt(2.0));
+
+  std::lock_guard<std::mutex> lk(mutex_);
+  for (int i = 0; i < 8; ++i) {
+    const int nx = x + offs[i][0];
+    const int ny = y + offs[i][1];
+    if (nx < 0 || ny < 0 || nx >= width_ || ny >= height_) continue;
+    if (!walkableAt(nx, ny)) continue;
+    const NodeId nid = static_cast<NodeId>(ny) * static_cast<NodeId>(width_) + static_cast<NodeId>(nx);
+    out.push_back(Edge{nid, (i < 4) ? 1.0 : diagonal});
+  }
+}
+
+Point PagedGridGraph::getNodePosition(NodeId nodeId) const {
+  if (nodeId >= getNodeCount()) {
+    LOG_WARN("PagedGridGraph::getNodePosition: invalid nodeId=" + std::to_string(nodeId));
+    return Point{0, 0};
+  }
+  return Point{static_cast<int>(nodeId % static_cast<NodeId>(width_)),
+               static_cast<int>(nodeId / static_cast<NodeId>(width_))};
+}
+
+std::size_t PagedGridGraph::getResidentTileCount() const {
+  std::lock_guard<std::mutex> lk(mutex_);
+  return tiles_.size();
+}
+
+std::size_t PagedGridGraph::getTileLoadCount() const {
+  std::lock_guard<std::mutex> lk(mutex_);
+  return tileLoads_;
+}
@@ -0,0 +1,359 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+
+#include "api/PathDatabase.hh"
+#include "algorithms/ChainCode.hh"
+#include "algorithms/DijkstraWorkspace.hh"
+#include "algorithms/ScoreTraits.hh"
+#include "utils/Logger.hh"
+#include "utils/QueryArena.hh"
+#include "utils/ThreadBudget.hh"
+
+namespace {
+
+constexpr char kMagic[4] = {'P', 'F', 'P', 'D'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kDiagonalFlag = 1;
+
+// A run packs the rank of its first target above a 3-bit chain code.
+constexpr unsigned kCodeBits = 3;
+constexpr uint64_t kMaxCells = uint64_t{1} << (32 - kCodeBits);
+
+// Path costs this close, relative to their size, are ties: octile sums of the same moves taken in
+// another order may differ in the last bits.
+constexpr Cost kTieTolerance = 1e-12;
+
+// The moves Dijkstra takes out of every cell, in CSR form: those of u are [offsets[u], offsets[u + 1])
+// in targets, costs and codes. Built once and shared by the workers, as every search expands
+// nearly every cell.
+struct Moves {
+  std::vector<std::size_t> offsets;
+  std::vector<NodeId> targets;
+  std::vector<Cost> costs;
+  std::vector<uint8_t> codes;
+};
+
+// A worker's search state, allocated from its own arena and reused from one source to the next.
+struct Workspace {
+  utils::QueryArena::Scope arena;
+  DijkstraWorkspace search;
+  std::pmr::vector<uint8_t> moves;  // bit c set: chain code c starts a shortest path to the node
+
+  explicit Workspace(NodeCount n) : search(n, arena.resource()), moves(n, 0, arena.resource()) {}
+};
+
+uint8_t codeOf(int dx, int dy) {
+  uint8_t code = 0;
+  while (code < 7 && (ChainCode::step(code).x != dx || ChainCode::step(code).y != dy)) ++code;
+  return code;
+}
+
+// Cells sorted along a Z-order (Morton) curve. Targets close on the grid mostly share a first
+// move, and stay closer together in this order than row by row, so rows need fewer runs.
+std::vector<NodeId> mortonOrder(int width, int height) {
+  const auto interleave = [](uint32_t x, uint32_t y) {
+    uint64_t key = 0;
+    for (unsigned b = 0; b < 32; ++b) key |= (uint64_t{(x >> b) & 1} << (2 * b)) | (uint64_t{(y >> b) & 1} << (2 * b + 1));
+    return key;
+  };
+  std::vector<std::pair<uint64_t, NodeId>> keyed;
+  keyed.reserve(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      keyed.push_back({interleave(static_cast<uint32_t>(x), static_cast<uint32_t>(y)), static_cast<NodeId>(y * width + x)});
+    }
+  }
+  std::sort(keyed.begin(), keyed.end());
+  std::vector<NodeId> order;
+  order.reserve(keyed.size());
+  for (const auto& k : keyed) order.push_back(k.second);
+  return order;
+}
+
+Moves buildMoves(const GridGraph& graph, int width, bool allowDiagonal) {
+  const NodeCount n = graph.getNodeCount();
+  const auto w = static_cast<NodeId>(width);
+  Moves moves;
+  moves.offsets.reserve(static_cast<std::size_t>(n) + 1);
+  moves.offsets.push_back(0);
+  std::vector<Edge> neighbors;
+  for (NodeId u = 0; u < n; ++u) {
+    graph.getNeighbors(u, neighbors);
+    for (const Edge& e : neighbors) {
+      const int dx = static_cast<int>(e.id % w) - static_cast<int>(u % w);
+      const int dy = static_cast<int>(e.id / w) - static_cast<int>(u / w);
+      if (!allowDiagonal && dx != 0 && dy != 0) continue;
+      moves.targets.push_back(e.id);
+      moves.costs.push_back(e.cost);
+      moves.codes.push_back(codeOf(dx, dy));
+    }
+    moves.offsets.push_back(moves.targets.size());
+  }
+  return moves;
+}
+
+// Full Dijkstra from source, recording in ws.moves every first move that starts a shortest path to
+// each node, then the row over targets in Morton order (order[rank] is the cell of a rank),
+// run-length compressed. A run keeps growing while some move suits all of its targets, so ties
+// are settled in whichever way saves runs. Unreached nodes and the source suit any move.
+std::vector<uint32_t> buildRow(const Moves& moves, const std::vector<NodeId>& order, NodeId source, Workspace& ws) {
+  ws.search.start(source);
+  Cost d;
+  NodeId u;
+  while (ws.search.pop(d, u)) {
+    for (std::size_t m = moves.offsets[u]; m < moves.offsets[u + 1]; ++m) {
+      const NodeId v = moves.targets[m];
+      const Cost nd = d + moves.costs[m];
+      const uint8_t first = u == source ? static_cast<uint8_t>(1u << moves.codes[m]) : ws.moves[u];
+      if (nd < ws.search.dist(v) * (1.0 - kTieTolerance)) {
+        ws.search.improve(v, nd);
+        ws.moves[v] = first;
+      } else if (nd <= ws.search.dist(v) * (1.0 + kTieTolerance)) {
+        // v is not settled yet: costs are positive, so it comes after u.
+        ws.moves[v] |= first;
+      }
+    }
+  }
+
+  std::vector<uint32_t> row;
+  uint8_t open = 0;  // moves that suit every target of the open run
+  for (std::size_t rank = 0; rank < order.size(); ++rank) {
+    const uint8_t suits = ws.moves[order[rank]];
+    if (suits == 0) continue;
+    if ((open & suits) != 0) {
+      open &= suits;
+      continue;
+    }
+    if (!row.empty()) row.back() |= static_cast<uint32_t>(__builtin_ctz(open));
+    // The first run starts at rank 0 so every lookup lands in some run.
+    row.push_back(row.empty() ? 0u : static_cast<uint32_t>(rank) << kCodeBits);
+    open = suits;
+  }
+  if (!row.empty()) row.back() |= static_cast<uint32_t>(__builtin_ctz(open));
+
+  // Only what this search touched goes back to its initial state, not the whole array.
+  for (const NodeId v : ws.search.touched()) ws.moves[v] = 0;
+  ws.search.reset();
+  return row;
+}
+
+template <typename T>
+void writeArray(std::ofstream& out, const std::vector<T>& values) {
+  out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template <typename T>
+void readArray(std::ifstream& in, std::vector<T>& values, std::size_t count) {
+  values.resize(count);
+  in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+} // namespace
+
+PathDatabase::PathDatabase(
+    const uint8_t* grid,
+    std::size_t gridSize,
+    int width,
+    int height,
+    const EngineOptions& options,
+    unsigned maxThreads)
+    : width_(width), height_(height), allowDiagonal_(options.allowDiagonal) {
+  const uint64_t cells = static_cast<uint64_t>(std::max(width, 0)) * static_cast<uint64_t>(std::max(height, 0));
+  if (width <= 0 || height <= 0 || cells > kMaxCells) {
+    LOG_ERROR("PathDatabase ctor: unsupported dimensions " + std::to_string(width) + "x" + std::to_string(height));
+    throw std::invalid_argument("unsupported path database dimensions");
+  }
+
+  const auto n = static_cast<std::size_t>(cells);
+  costs_.assign(n, 0.0);
+  for (std::size_t i = 0; i < n; ++i) {
+    if (i >= gridSize || grid[i] != 0) continue;
+    costs_[i] = options.terrain.empty() ? 1.0 : options.terrain.at(i);
+  }
+  prepare();
+
+  const auto t0 = std::chrono::steady_clock::now();
+  const Moves moves = buildMoves(*graph_, width_, allowDiagonal_);
+  std::vector<NodeId> order(n);
+  for (std::size_t cell = 0; cell < n; ++cell) order[rank_[cell]] = static_cast<NodeId>(cell);
+  std::vector<std::vector<uint32_t>> rows(n);
+
+  // Each source writes only its own row.
+  const auto nodes = static_cast<NodeCount>(n);
+  utils::parallelFor(n, maxThreads, [nodes] { return Workspace(nodes); }, [&](std::size_t s, Workspace& ws) {
+    if (costs_[s] == 0.0) return;
+    rows[s] = buildRow(moves, order, static_cast<NodeId>(s), ws);
+  });
+
+  rowOffsets_.reserve(n + 1);
+  rowOffsets_.push_back(0);
+  for (const auto& row : rows) rowOffsets_.push_back(rowOffsets_.back() + row.size());
+  runs_.reserve(static_cast<std::size_t>(rowOffsets_.back()));
+  for (auto& row : rows) {
+    runs_.insert(runs_.end(), row.begin(), row.end());
+    std::vector<uint32_t>().swap(row);
+  }
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0);
+  LOG_INFO("PathDatabase: " + std::to_string(n) + " cells, " + std::to_string(runs_.size()) + " runs (" +
+           std::to_string(bytes()) + " bytes) built in " + std::to_string(elapsed.count()) + " ms");
+}
+
+PathDatabase::PathDatabase(const std::string& path) : width_(0), height_(0), allowDiagonal_(false) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    LOG_ERROR("PathDatabase ctor: cannot open " + path);
+    throw std::runtime_error("cannot open path database " + path);
+  }
+
+  char magic[4];
+  uint32_t header[4];
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || header[0] != kVersion) {
+    LOG_ERROR("PathDatabase ctor: invalid header in " + path);
+    throw std::runtime_error("invalid path database header in " + path);
+  }
+
+  const uint64_t cells = static_cast<uint64_t>(header[1]) * header[2];
+  if (header[1] == 0 || header[2] == 0 || cells > kMaxCells) {
+    LOG_ERROR("PathDatabase ctor: unsupported dimensions in " + path);
+    throw std::runtime_error("unsupported path database dimensions in " + path);
+  }
+  width_ = static_cast<int>(header[1]);
+  height_ = static_cast<int>(header[2]);
+  allowDiagonal_ = (header[3] & kDiagonalFlag) != 0;
+
+  // The file must hold exactly the costs, the offsets and the runs they announce; checked before
+  // anything is allocated, so a bad header cannot ask for gigabytes.
+  const auto n = static_cast<std::size_t>(cells);
+  const std::streamoff here = in.tellg();
+  in.seekg(0, std::ios::end);
+  const auto left = static_cast<uint64_t>(in.tellg() - here);
+  in.seekg(here);
+  const uint64_t fixedBytes = n * sizeof(Cost) + (n + 1) * sizeof(uint64_t);
+  bool valid = left >= fixedBytes && (left - fixedBytes) % sizeof(uint32_t) == 0;
+  if (valid) {
+    readArray(in, costs_, n);
+    readArray(in, rowOffsets_, n + 1);
+    valid = static_cast<bool>(in) && rowOffsets_.front() == 0 &&
+            rowOffsets_.back() == (left - fixedBytes) / sizeof(uint32_t);
+  }
+  for (std::size_t s = 0; valid && s < n; ++s) {
+    valid = rowOffsets_[s] <= rowOffsets_[s + 1] && costs_[s] >= 0.0 && costs_[s] <= std::numeric_limits<Cost>::max();
+  }
+  if (valid) readArray(in, runs_, static_cast<std::size_t>(rowOffsets_.back()));
+  if (!valid || !in) {
+    LOG_ERROR("PathDatabase ctor: truncated or corrupt table in " + path);
+    throw std::runtime_error("corrupt path database " + path);
+  }
+  prepare();
+
+  LOG_INFO("PathDatabase ctor: loaded " + path + " width=" + std::to_string(width_) + " height=" +
+           std::to_string(height_) + " runs=" + std::to_string(runs_.size()));
+}
+
+void PathDatabase::prepare() {
+  const std::vector<NodeId> order = mortonOrder(width_, height_);
+  rank_.assign(order.size(), 0);
+  for (std::size_t rank = 0; rank < order.size(); ++rank) rank_[order[rank]] = static_cast<uint32_t>(rank);
+
+  std::vector<Node> nodes;
+  nodes.reserve(costs_.size());
+  for (int y = 0; y < height_; ++y) {
+    for (int x = 0; x < width_; ++x) {
+      const int idx = y * width_ + x;
+      const Cost c = costs_[static_cast<std::size_t>(idx)];
+      nodes.push_back(Node{static_cast<NodeId>(idx), Point{x, y}, c > 0.0, c > 0.0 ? c : 1.0});
+    }
+  }
+  graph_ = std::make_shared<GridGraph>(width_, height_, nodes);
+  graph_->buildComponents();
+}
+
+void PathDatabase::save(const std::string& path) const {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    LOG_ERROR("PathDatabase::save: cannot open " + path);
+    throw std::runtime_error("cannot write path database " + path);
+  }
+
+  const uint32_t header[4] = {kVersion, static_cast<uint32_t>(width_), static_cast<uint32_t>(height_),
+                              allowDiagonal_ ? kDiagonalFlag : 0u};
+  out.write(kMagic, sizeof(kMagic));
+  out.write(reinterpret_cast<const char*>(header), sizeof(header));
+  writeArray(out, costs_);
+  writeArray(out, rowOffsets_);
+  writeArray(out, runs_);
+
+  if (!out) {
+    LOG_ERROR("PathDatabase::save: write failed for " + path);
+    throw std::runtime_error("write failed for path database " + path);
+  }
+}
+
+Result PathDatabase::findPath(int startIndex, int goalIndex) const {
+  const auto t0 = std::chrono::steady_clock::now();
+  Result res;
+  res.success = false;
+  res.cost = 0.0;
+  res.time = Time::zero();
+
+  const NodeCount n = graph_->getNodeCount();
+  if (startIndex < 0 || goalIndex < 0 || static_cast<NodeCount>(startIndex) >= n ||
+      static_cast<NodeCount>(goalIndex) >= n || !graph_->isWalkable(static_cast<NodeId>(startIndex))) {
+    LOG_ERROR("PathDatabase::findPath: invalid start=" + std::to_string(startIndex) + " goal=" +
+              std::to_string(goalIndex));
+    res.status = SearchStatus::INVALID_INPUT;
+    return res;
+  }
+
+  const auto start = static_cast<NodeId>(startIndex);
+  const auto goal = static_cast<NodeId>(goalIndex);
+  if (!graph_->isWalkable(goal) || !graph_->sameComponent(start, goal, allowDiagonal_)) {
+    res.status = SearchStatus::NO_PATH;
+    res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+    return res;
+  }
+
+  // The run covering goal in a row is the last one starting at or before it.
+  const uint32_t key = (rank_[goal] << kCodeBits) | ((1u << kCodeBits) - 1);
+  res.path.push_back(start);
+  for (NodeId cur = start; cur != goal;) {
+    const auto first = runs_.begin() + static_cast<std::ptrdiff_t>(rowOffsets_[cur]);
+    const auto last = runs_.begin() + static_cast<std::ptrdiff_t>(rowOffsets_[cur + 1]);
+    const auto run = std::upper_bound(first, last, key);
+    const Point d = ChainCode::step(static_cast<uint8_t>(run == first ? 0 : *(run - 1)));
+    const int x = static_cast<int>(cur % static_cast<NodeId>(width_)) + d.x;
+    const int y = static_cast<int>(cur / static_cast<NodeId>(width_)) + d.y;
+    const NodeId nextCell = static_cast<NodeId>(y * width_ + x);
+    // Only a corrupt table can step off the grid, into a wall or around in circles.
+    if (run == first || x < 0 || y < 0 || x >= width_ || y >= height_ || !graph_->isWalkable(nextCell) ||
+        res.path.size() > n) {
+      LOG_ERROR("PathDatabase::findPath: broken first-move chain at cell " + std::to_string(cur));
+      res.path.clear();
+      res.status = SearchStatus::NO_PATH;
+      res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+      return res;
+    }
+    res.path.push_back(nextCell);
+    cur = nextCell;
+  }
+
+  res.cost = pathCost(*graph_, res.path);
+  res.success = true;
+  res.status = SearchStatus::SUCCESS;
+  res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+  return res;
+}
@@ -0,0 +1,65 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <string>
+
+#include "algorithms/PathSmoother.hh"
+#include "utils/Logger.hh"
+
+void PathSmoother::apply(const IGraph& graph, PathSmoothing mode, Result& result) {
+  if (mode == PathSmoothing::NONE || result.path.empty()) return;
+
+  // Shortcuts through cells of different cost could make the route dearer, so those grids only
+  // get the lossless turning points.
+  if (mode == PathSmoothing::STRING_PULL && graph.isUniformGrid()) {
+    stringPull(graph, result.path, result.waypoints);
+    result.waypointCost = graph.getMinStepCost() * length(graph, result.waypoints);
+  } else {
+    turningPoints(graph, result.path, result.waypoints);
+    result.waypointCost = result.cost;
+  }
+  LOG_DEBUG("PathSmoother: " + std::to_string(result.path.size()) + " nodes -> " +
+            std::to_string(result.waypoints.size()) + " waypoints");
+}
+
+void PathSmoother::turningPoints(const IGraph& graph, const std::pmr::vector<NodeId>& path, std::pmr::vector<NodeId>& out) {
+  out.clear();
+  if (path.empty()) return;
+  out.push_back(path.front());
+  for (std::size_t i = 1; i + 1 < path.size(); ++i) {
+    const Point a = graph.getNodePosition(path[i - 1]);
+    const Point b = graph.getNodePosition(path[i]);
+    const Point c = graph.getNodePosition(path[i + 1]);
+    if (b.x - a.x != c.x - b.x || b.y - a.y != c.y - b.y) out.push_back(path[i]);
+  }
+  if (path.size() > 1) out.push_back(path.back());
+}
+
+void PathSmoother::stringPull(const IGraph& graph, const std::pmr::vector<NodeId>& path, std::pmr::vector<NodeId>& out) {
+  out.clear();
+  if (path.empty()) return;
+  out.push_back(path.front());
+  // path[anchor] reaches path[i] in a straight line (or by a single edge); path[i] becomes a
+  // waypoint only when path[anchor] cannot also see path[i + 1].
+  std::size_t anchor = 0;
+  for (std::size_t i = 1; i + 1 < path.size(); ++i) {
+    if (!graph.lineOfSight(path[anchor], path[i + 1])) {
+      out.push_back(path[i]);
+      anchor = i;
+    }
+  }
+  if (path.size() > 1) out.push_back(path.back());
+}
+
+Cost PathSmoother::length(const IGraph& graph, const std::pmr::vector<NodeId>& waypoints) {
+  Cost total = 0.0;
+  for (std::size_t i = 1; i < waypoints.size(); ++i) {
+    const Point a = graph.getNodePosition(waypoints[i - 1]);
+    const Point b = graph.getNodePosition(waypoints[i]);
+    total += std::hypot(static_cast<Cost>(a.x - b.x), static_cast<Cost>(a.y - b.y));
+  }
+  return total;
+}
@@ -1,50 +1,293 @@
 #include "api/PathfindingEngine.hh"
 
+#include <algorithm>
+#include <chrono>
+#include <map>
 #include <memory>
+#include <memory_resource>
+#include <string>
+#include <tuple>
+#include "api/LabelCache.hh"
 #include "graph/GridGraph.hh"
 #include "factories/HeuristicFactory.hh"
 #include "factories/AlgorithmFactory.hh"
+#include "algorithms/ChainCode.hh"
+#include "algorithms/DistanceMatrix.hh"
+#include "algorithms/MultiSourceBFS.hh"
+#include "algorithms/PathSmoother.hh"
+#include "utils/Logger.hh"
+#include "utils/QueryArena.hh"
+#include "utils/ThreadBudget.hh"
 
-Result PathfindingEngine::findPath(
-    const std::vector<int>& grid,
+namespace {
+
+// The grid graph of a query (0 = walkable, non-zero = blocked) with the optional terrain layer,
+// its arrays allocated from memory.
+template <typename Cell>
+std::shared_ptr<GridGraph> gridGraph(
+    const Cell* grid,
+    std::size_t gridSize,
     int width,
     int height,
-    int startIndex,
-    int goalIndex,
-    AlgorithmType algorithm,
-    HeuristicType heuristic,
-    bool allowDiagonal,
-    bool dontCrossCorners,
-    bool bidirectional) {
-  // Build nodes from the grid (0 = walkable, non-zero = blocked)
-  std::vector<Node> nodes;
-  nodes.reserve(width * height);
+    const TerrainCosts& terrain,
+    std::pmr::memory_resource* memory) {
+  std::pmr::vector<Node> nodes(memory);
+  nodes.reserve(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
   for (int y = 0; y < height; ++y) {
     for (int x = 0; x < width; ++x) {
       int idx = y * width + x;
       Node n;
       n.id = static_cast<NodeId>(idx);
       n.position = Point{x, y};
-      n.walkable = (idx < (int)grid.size()) ? (grid[idx] == 0) : false;
+      n.walkable = (static_cast<std::size_t>(idx) < gridSize) ? (grid[idx] == 0) : false;
       n.cost = 1.0;
+      if (!terrain.empty()) {
+        const Cost c = terrain.at(static_cast<std::size_t>(idx));
+        if (c > 0.0) n.cost = c;
+        else n.walkable = false;
+      }
       nodes.push_back(n);
     }
   }
+  return std::make_shared<GridGraph>(width, height, nodes.data(), nodes.size(), memory);
+}
+
+// Cell indices as NodeIds. Blocked and out-of-range cells become an id past the grid, which the
+// many-source searches skip.
+std::vector<NodeId> toNodeIds(const GridGraph& graph, const std::vector<int>& cells) {
+  const NodeCount n = graph.getNodeCount();
+  std::vector<NodeId> ids(cells.size(), n);
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    const int cell = cells[i];
+    if (cell >= 0 && static_cast<NodeCount>(cell) < n && graph.isWalkable(static_cast<NodeId>(cell))) {
+      ids[i] = static_cast<NodeId>(cell);
+    }
+  }
+  return ids;
+}
+
+template <typename Cell>
+Result runQuery(
+    const Cell* grid,
+    std::size_t gridSize,
+    int width,
+    int height,
+    int startIndex,
+    int goalIndex,
+    const EngineOptions& options) {
+  const auto t0 = std::chrono::steady_clock::now();
+
+  // Everything the query builds and drops, from the node array to the search's open list, is
+  // carved out of this thread's arena and released in one go when the scope ends. Declared first
+  // so it outlives the graph, heuristic and algorithm.
+  utils::QueryArena::Scope arena;
+  std::pmr::memory_resource* const memory = arena.resource();
+
+  auto graph = gridGraph(grid, gridSize, width, height, options.terrain, memory);
+
+  if (PathfindingEngine::unreachable(*graph, startIndex, goalIndex, options)) {
+    Result res(options.resultMemory); res.success = false; res.cost = 0.0; res.time = Time::zero();
+    res.status = SearchStatus::NO_PATH;
+    res.stats.graphBuildTime = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+    return res;
+  }
 
-  auto graph = std::make_shared<GridGraph>(width, height, nodes);
+  const Time graphBuildTime = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
 
-  // Configure heuristic and algorithm
-  std::shared_ptr<const IHeuristic> heur = nullptr;
-  if (algorithm == AlgorithmType::ASTAR) {
-    heur = HeuristicFactory::createHeuristic(heuristic, graph);
+  const AlgorithmConfig cfg = PathfindingEngine::algorithmConfig(options, graph, memory);
+  auto alg = AlgorithmFactory::createAlgorithm(options.algorithm);
+  Result res = alg->findPath(*graph, static_cast<NodeId>(startIndex), static_cast<NodeId>(goalIndex), cfg);
+  res.stats.graphBuildTime = graphBuildTime;
+  PathfindingEngine::postProcess(*graph, options, res);
+  return res;
+}
+
+} // namespace
+
+// A walled-off goal is every search's worst case: the whole reachable region gets expanded before
+// it gives up. The caller's component labels answer that in O(1) before any search runs; they are
+// never computed here, as labelling costs more than most searches it would save. 8-connectivity is
+// used whenever diagonals are on, as it never separates cells a search could still connect.
+bool PathfindingEngine::unreachable(const GridGraph& graph, int startIndex, int goalIndex, const EngineOptions& options) {
+  const NodeCount n = graph.getNodeCount();
+  if (startIndex == goalIndex || startIndex < 0 || goalIndex < 0 || static_cast<NodeCount>(startIndex) >= n ||
+      static_cast<NodeCount>(goalIndex) >= n) {
+    return false;
   }
+  const NodeId start = static_cast<NodeId>(startIndex);
+  const NodeId goal = static_cast<NodeId>(goalIndex);
+  if (graph.isWalkable(goal) &&
+      (options.components == nullptr || options.components->sameComponent(start, goal, options.allowDiagonal))) {
+    return false;
+  }
+  LOG_INFO("PathfindingEngine: goal=" + std::to_string(goalIndex) + " unreachable from start=" +
+           std::to_string(startIndex) + ", search skipped");
+  return true;
+}
 
+// Configure heuristic and algorithm (uninformed algorithms simply ignore the heuristic)
+AlgorithmConfig PathfindingEngine::algorithmConfig(
+    const EngineOptions& options,
+    const std::shared_ptr<GridGraph>& graph,
+    std::pmr::memory_resource* memory) {
   AlgorithmConfig cfg;
-  cfg.heuristic = heur;
-  cfg.allowDiagonal = allowDiagonal;
-  cfg.dontCrossCorners = dontCrossCorners;
-  cfg.bidirectional = bidirectional;
+  cfg.heuristic = HeuristicFactory::createHeuristic(options.heuristic, graph);
+  cfg.allowDiagonal = options.allowDiagonal;
+  cfg.dontCrossCorners = options.dontCrossCorners;
+  cfg.bidirectional = options.bidirectional;
+  cfg.recording = options.recording;
+  cfg.recordingSampleRate = options.recordingSampleRate;
+  cfg.onVisited = options.onVisited;
+  cfg.visitChunkSize = options.visitChunkSize;
+  cfg.weight = options.weight;
+  if (options.timeBudget > Time::zero()) {
+    cfg.deadline = std::chrono::steady_clock::now() + options.timeBudget;
+  }
+  cfg.maxExpansions = options.maxExpansions;
+  cfg.cancel = options.cancel;
+  cfg.tieBreaking = options.tieBreaking;
+  cfg.canonicalOrdering = options.canonicalOrdering;
+  cfg.precision = options.precision;
+  cfg.memory = memory;
+  cfg.resultMemory = options.resultMemory;
+  return cfg;
+}
 
-  auto alg = AlgorithmFactory::createAlgorithm(algorithm);
-  return alg->findPath(*graph, static_cast<NodeId>(startIndex), static_cast<NodeId>(goalIndex), cfg);
+void PathfindingEngine::postProcess(const GridGraph& graph, const EngineOptions& options, Result& res) {
+  if (options.chainCode) ChainCode::apply(graph, res);
+  if (options.smoothing != PathSmoothing::NONE && !res.path.empty()) {
+    const auto smoothStart = std::chrono::steady_clock::now();
+    PathSmoother::apply(graph, options.smoothing, res);
+    res.stats.smoothingTime = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - smoothStart);
+  }
+  if (!options.keepCellPath && (!res.waypoints.empty() || !res.chainCode.empty())) {
+    std::pmr::vector<NodeId>(res.path.get_allocator()).swap(res.path);
+  }
+}
+
+std::shared_ptr<GridGraph> PathfindingEngine::buildGraph(
+    const uint8_t* grid,
+    std::size_t gridSize,
+    int width,
+    int height,
+    const TerrainCosts& terrain,
+    std::pmr::memory_resource* memory) {
+  return gridGraph(grid, gridSize, width, height, terrain, memory);
+}
+
+Result PathfindingEngine::findPath(
+    const std::vector<int>& grid,
+    int width,
+    int height,
+    int startIndex,
+    int goalIndex,
+    AlgorithmType algorithm,
+    HeuristicType heuristic,
+    bool allowDiagonal,
+    bool dontCrossCorners,
+    bool bidirectional) {
+  EngineOptions options;
+  options.algorithm = algorithm;
+  options.heuristic = heuristic;
+  options.allowDiagonal = allowDiagonal;
+  options.dontCrossCorners = dontCrossCorners;
+  options.bidirectional = bidirectional;
+  return runQuery(grid.data(), grid.size(), width, height, startIndex, goalIndex, options);
+}
+
+Result PathfindingEngine::findPath(
+    const uint8_t* grid,
+    std::size_t gridSize,
+    int width,
+    int height,
+    int startIndex,
+    int goalIndex,
+    const EngineOptions& options) {
+  return runQuery(grid, gridSize, width, height, startIndex, goalIndex, options);
+}
+
+std::vector<Result> PathfindingEngine::findPaths(const std::vector<PathQuery>& queries, unsigned maxThreads) {
+  // Each slot already uses its query's resultMemory, so assigning the answer into it moves the
+  // arrays rather than copying them to the default heap.
+  std::vector<Result> results;
+  results.reserve(queries.size());
+  for (const PathQuery& q : queries) results.emplace_back(q.options.resultMemory);
+  if (queries.empty()) return results;
+
+  // Queries that share a grid (and terrain) without bringing labels share labels made here, so a
+  // walled-off goal among them is answered without a search. A grid searched once is not worth it.
+  using GridKey = std::tuple<const uint8_t*, std::size_t, int, int, const uint8_t*, const float*, std::size_t>;
+  std::map<GridKey, std::vector<std::size_t>> sharing;
+  for (std::size_t i = 0; i < queries.size(); ++i) {
+    const PathQuery& q = queries[i];
+    if (q.options.components != nullptr) continue;
+    const TerrainCosts& t = q.options.terrain;
+    sharing[GridKey{q.grid, q.gridSize, q.width, q.height, t.bytes, t.values, t.size}].push_back(i);
+  }
+  std::vector<std::shared_ptr<const ComponentLabels>> labels(queries.size());
+  for (const auto& group : sharing) {
+    if (group.second.size() < 2) continue;
+    const PathQuery& q = queries[group.second.front()];
+    const std::shared_ptr<const ComponentLabels> shared =
+        LabelCache::label(q.grid, q.gridSize, q.width, q.height, q.options.terrain);
+    for (const std::size_t i : group.second) labels[i] = shared;
+  }
+
+  // Each query writes only its own slot.
+  const unsigned threads = utils::parallelFor(queries.size(), maxThreads, [&](std::size_t i) {
+    const PathQuery& q = queries[i];
+    if (!labels[i]) {
+      results[i] = runQuery(q.grid, q.gridSize, q.width, q.height, q.startIndex, q.goalIndex, q.options);
+      return;
+    }
+    EngineOptions labelled = q.options;
+    labelled.components = labels[i].get();
+    results[i] = runQuery(q.grid, q.gridSize, q.width, q.height, q.startIndex, q.goalIndex, labelled);
+  });
+
+  LOG_INFO("PathfindingEngine: batch of " + std::to_string(queries.size()) + " queries on " +
+           std::to_string(threads) + " thread(s)");
+  return results;
+}
+
+std::vector<uint32_t> PathfindingEngine::hopDistances(
+    const uint8_t* grid,
+    std::size_t gridSize,
+    int width,
+    int height,
+    const std::vector<int>& sources,
+    const std::vector<int>& targets,
+    const EngineOptions& options) {
+  utils::QueryArena::Scope arena;
+  auto graph = buildGraph(grid, gridSize, width, height, options.terrain, arena.resource());
+
+  const std::vector<NodeId> from = toNodeIds(*graph, sources);
+  if (targets.empty()) {
+    return MultiSourceBFS::distanceFields(*graph, from, options.allowDiagonal, options.dontCrossCorners);
+  }
+  return MultiSourceBFS::distanceMatrix(*graph, from, toNodeIds(*graph, targets), options.allowDiagonal,
+                                        options.dontCrossCorners);
+}
+
+std::vector<Cost> PathfindingEngine::costMatrix(
+    const uint8_t* grid,
+    std::size_t gridSize,
+    int width,
+    int height,
+    const std::vector<int>& sources,
+    const std::vector<int>& targets,
+    const EngineOptions& options,
+    unsigned maxThreads) {
+  utils::QueryArena::Scope arena;
+  auto graph = buildGraph(grid, gridSize, width, height, options.terrain, arena.resource());
+  if (options.components == nullptr) graph->buildComponents();
+  const bool diagonal = options.allowDiagonal;
+  const GridGraph& labelled = *graph;
+  const ComponentLabels* const components = options.components;
+  return DistanceMatrix::compute(
+      labelled, toNodeIds(labelled, sources), toNodeIds(labelled, targets), diagonal, maxThreads,
+      [&labelled, components, diagonal](NodeId from, NodeId to) {
+        return components != nullptr ? components->sameComponent(from, to, diagonal)
+                                     : labelled.sameComponent(from, to, diagonal);
+      });
 }
@@ -0,0 +1,81 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <memory>
+
+#include "utils/QueryArena.hh"
+
+namespace utils {
+
+namespace {
+
+// First block of a thread; enough for the temporaries of a small map.
+constexpr std::size_t kInitialBytes = std::size_t{64} << 10;
+
+// Uninitialised: make_unique<std::byte[]> would zero-fill up to kMaxRetainedBytes that the
+// monotonic arena overwrites anyway.
+std::unique_ptr<std::byte[]> allocateBlock(std::size_t size) { return std::unique_ptr<std::byte[]>(new std::byte[size]); }
+
+} // namespace
+
+struct QueryArena::Block {
+  std::unique_ptr<std::byte[]> data;
+  std::size_t size = 0;
+  bool busy = false;
+};
+
+QueryArena::Block& QueryArena::threadBlock() {
+  static thread_local Block block;
+  return block;
+}
+
+std::size_t QueryArena::retainedBytes() { return threadBlock().size; }
+
+void QueryArena::trim() {
+  Block& block = threadBlock();
+  if (block.busy) return;
+  block.data.reset();
+  block.size = 0;
+}
+
+QueryArena::Scope::Scope() : block_(nullptr) {
+  Block& block = threadBlock();
+  if (block.busy) {
+    arena_.emplace(&overflow_);
+    return;
+  }
+  if (!block.data) {
+    block.data = allocateBlock(kInitialBytes);
+    block.size = kInitialBytes;
+  }
+  block.busy = true;
+  block_ = &block;
+  arena_.emplace(block.data.get(), block.size, &overflow_);
+}
+
+QueryArena::Scope::~Scope() {
+  arena_.reset();
+  if (!block_) return;
+  // Grow so that a query like this one fits next time.
+  if (overflow_.bytes > 0 && block_->size < kMaxRetainedBytes) {
+    const std::size_t size = std::min(kMaxRetainedBytes, block_->size + overflow_.bytes);
+    block_->data.reset();
+    block_->data = allocateBlock(size);
+    block_->size = size;
+  }
+  block_->busy = false;
+}
+
+void* QueryArena::Scope::Overflow::do_allocate(std::size_t size, std::size_t alignment) {
+  bytes += size;
+  return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void QueryArena::Scope::Overflow::do_deallocate(void* p, std::size_t size, std::size_t alignment) {
+  std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+}
+
+} // namespace utils
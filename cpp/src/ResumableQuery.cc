@@ -0,0 +1,63 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include "api/ResumableQuery.hh"
+
+#include <chrono>
+#include <utility>
+
+#include "utils/Logger.hh"
+
+ResumableQuery::ResumableQuery(
+    const uint8_t* grid,
+    std::size_t gridSize,
+    int width,
+    int height,
+    int startIndex,
+    int goalIndex,
+    const EngineOptions& options)
+    : options_(options), result_(options.resultMemory) {
+  result_.success = false; result_.cost = 0.0; result_.time = Time::zero();
+  if (options.algorithm != AlgorithmType::ASTAR && options.algorithm != AlgorithmType::DIJKSTRA) {
+    LOG_ERROR("ResumableQuery: only ASTAR and DIJKSTRA can be stepped");
+    result_.status = SearchStatus::INVALID_INPUT;
+    done_ = true;
+    return;
+  }
+  graph_ = PathfindingEngine::buildGraph(grid, gridSize, width, height, options.terrain, &memory_);
+  if (PathfindingEngine::unreachable(*graph_, startIndex, goalIndex, options)) {
+    result_.status = SearchStatus::NO_PATH;
+    done_ = true;
+    return;
+  }
+
+  // Out-of-range indices wrap to large NodeIds, which the search rejects as invalid input.
+  const AlgorithmConfig cfg = PathfindingEngine::algorithmConfig(options, graph_, &memory_);
+  search_ = AStarSearch::create(*graph_, static_cast<NodeId>(startIndex), static_cast<NodeId>(goalIndex), cfg,
+                                options.algorithm == AlgorithmType::ASTAR);
+  if (search_->done()) finish(search_->release());
+}
+
+void ResumableQuery::finish(Result res) {
+  result_ = std::move(res);
+  PathfindingEngine::postProcess(*graph_, options_, result_);
+  done_ = true;
+  // The search's arrays are no longer needed; the arena keeps their memory until the query goes.
+  search_.reset();
+}
+
+bool ResumableQuery::step(Time budget) {
+  if (done_) return true;
+  if (search_->run(std::chrono::steady_clock::now() + budget)) finish(search_->release());
+  return done_;
+}
+
+bool ResumableQuery::done() const {
+  return done_;
+}
+
+const Result& ResumableQuery::result() const {
+  return done_ || !search_ ? result_ : search_->result();
+}
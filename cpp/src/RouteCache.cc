@@ -0,0 +1,362 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include "api/RouteCache.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "algorithms/ChainCode.hh"
+#include "utils/Logger.hh"
+
+namespace {
+
+void hashCombine(std::size_t& seed, std::size_t value) {
+  seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+// Cost of one move on the engine's grid, matching GridGraph's edge costs: the cost of entering the
+// target cell, times sqrt(2) for a diagonal.
+Cost stepCost(int width, const TerrainCosts& terrain, NodeId from, NodeId to) {
+  const int dx = std::abs(static_cast<int>(from % width) - static_cast<int>(to % width));
+  const int dy = std::abs(static_cast<int>(from / width) - static_cast<int>(to / width));
+  const Cost enter = terrain.empty() ? 1.0 : terrain.at(to);
+  return (dx == 1 && dy == 1) ? enter * std::sqrt(2.0) : enter;
+}
+
+// Whether the straight segment from `from` to `to` runs through cell: one of the cells
+// GridGraph::lineOfSight walks between them or, where the segment crosses a grid corner, one of
+// the two cells beside that corner. Steps between 8-neighbours are the short case; any-angle routes
+// (Theta*, smoothing) have longer segments. With dontCrossCorners a diagonal step is only legal
+// while both cells beside it are open, so those count too.
+bool segmentTouches(int width, NodeId from, NodeId to, NodeId cell, bool dontCrossCorners) {
+  const int cx = static_cast<int>(cell % static_cast<NodeId>(width));
+  const int cy = static_cast<int>(cell / static_cast<NodeId>(width));
+  int x = static_cast<int>(from % static_cast<NodeId>(width));
+  int y = static_cast<int>(from / static_cast<NodeId>(width));
+  const int x1 = static_cast<int>(to % static_cast<NodeId>(width));
+  const int y1 = static_cast<int>(to / static_cast<NodeId>(width));
+  const int dx = std::abs(x1 - x);
+  const int dy = std::abs(y1 - y);
+  if (cx < std::min(x, x1) || cx > std::max(x, x1) || cy < std::min(y, y1) || cy > std::max(y, y1)) return false;
+  const int sx = x1 > x ? 1 : -1;
+  const int sy = y1 > y ? 1 : -1;
+  // A line-of-sight check reads the cells beside a corner; a single diagonal step only does so
+  // under the corner rule.
+  const bool corners = dx > 1 || dy > 1 || dontCrossCorners;
+
+  int error = dx - dy;
+  for (;;) {
+    if (x == cx && y == cy) return true;
+    if (x == x1 && y == y1) return false;
+    if (error > 0) {
+      x += sx;
+      error -= 2 * dy;
+    } else if (error < 0) {
+      y += sy;
+      error += 2 * dx;
+    } else {
+      if (corners && ((x + sx == cx && y == cy) || (x == cx && y + sy == cy))) return true;
+      x += sx;
+      y += sy;
+      error += 2 * (dx - dy);
+    }
+  }
+}
+
+bool polylineTouches(int width, const std::pmr::vector<NodeId>& points, NodeId cell, bool dontCrossCorners) {
+  if (points.size() == 1) return points.front() == cell;
+  for (std::size_t i = 1; i < points.size(); ++i) {
+    if (segmentTouches(width, points[i - 1], points[i], cell, dontCrossCorners)) return true;
+  }
+  return false;
+}
+
+// Whether a cached route runs through cell, whichever of its forms were kept: the path (cells, or
+// corners for any-angle searches), the waypoints and the chain code.
+bool routeTouches(int width, const Result& route, NodeId cell, bool dontCrossCorners) {
+  if (polylineTouches(width, route.path, cell, dontCrossCorners) ||
+      polylineTouches(width, route.waypoints, cell, dontCrossCorners)) {
+    return true;
+  }
+  if (route.chainCode.empty()) return false;
+  NodeId at = route.chainStart;
+  if (at == cell) return true;
+  for (const uint8_t code : route.chainCode) {
+    const Point d = ChainCode::step(code);
+    const NodeId next = static_cast<NodeId>(static_cast<long long>(at) + static_cast<long long>(d.y) * width + d.x);
+    if (segmentTouches(width, at, next, cell, dontCrossCorners)) return true;
+    at = next;
+  }
+  return false;
+}
+
+} // namespace
+
+bool RouteCache::ConfigKey::operator==(const ConfigKey& o) const {
+  return mapVersion == o.mapVersion && algorithm == o.algorithm && heuristic == o.heuristic &&
+         allowDiagonal == o.allowDiagonal && dontCrossCorners == o.dontCrossCorners &&
+         bidirectional == o.bidirectional && weight == o.weight && tieBreaking == o.tieBreaking &&
+         canonicalOrdering == o.canonicalOrdering && precision == o.precision && smoothing == o.smoothing &&
+         chainCode == o.chainCode && keepCellPath == o.keepCellPath;
+}
+
+bool RouteCache::RouteKey::operator==(const RouteKey& o) const {
+  return config == o.config && start == o.start && goal == o.goal;
+}
+
+bool RouteCache::NodeKey::operator==(const NodeKey& o) const {
+  return config == o.config && node == o.node;
+}
+
+std::size_t RouteCache::KeyHash::operator()(const ConfigKey& k) const {
+  std::size_t seed = std::hash<uint64_t>()(k.mapVersion);
+  hashCombine(seed, static_cast<std::size_t>(k.algorithm));
+  hashCombine(seed, static_cast<std::size_t>(k.heuristic));
+  hashCombine(seed, (k.allowDiagonal ? 1u : 0u) | (k.dontCrossCorners ? 2u : 0u) | (k.bidirectional ? 4u : 0u) |
+                        (k.canonicalOrdering ? 8u : 0u) | (k.keepCellPath ? 16u : 0u) | (k.chainCode ? 32u : 0u));
+  hashCombine(seed, static_cast<std::size_t>(k.precision));
+  hashCombine(seed, static_cast<std::size_t>(k.smoothing));
+  hashCombine(seed, static_cast<std::size_t>(k.tieBreaking));
+  hashCombine(seed, std::hash<Cost>()(k.weight));
+  return seed;
+}
+
+std::size_t RouteCache::KeyHash::operator()(const RouteKey& k) const {
+  std::size_t seed = (*this)(k.config);
+  hashCombine(seed, k.start);
+  hashCombine(seed, k.goal);
+  return seed;
+}
+
+std::size_t RouteCache::KeyHash::operator()(const NodeKey& k) const {
+  std::size_t seed = (*this)(k.config);
+  hashCombine(seed, k.node);
+  return seed;
+}
+
+RouteCache::RouteCache(std::size_t capacity) : capacity_(std::max<std::size_t>(1, capacity)) {}
+
+RouteCache::ConfigKey RouteCache::configKey(uint64_t mapVersion, const EngineOptions& options) {
+  return ConfigKey{mapVersion, options.algorithm, options.heuristic, options.allowDiagonal,
+                   options.dontCrossCorners, options.bidirectional, std::max<Cost>(1.0, options.weight),
+                   options.tieBreaking, options.canonicalOrdering, options.precision, options.smoothing,
+                   options.chainCode, options.keepCellPath};
+}
+
+// Whether the options always yield a shortest path, which is what makes subpaths reusable.
+bool RouteCache::isOptimal(const EngineOptions& options) {
+  // Manhattan overestimates diagonal moves; the other heuristics are admissible on both grids.
+  const bool admissible = !(options.allowDiagonal && options.heuristic == HeuristicType::MANHATTAN);
+  // Narrower scores may settle for a path within their rounding of the shortest one.
+  if (options.precision != CostPrecision::DOUBLE) return false;
+  switch (options.algorithm) {
+    case AlgorithmType::DIJKSTRA:
+      return true;
+    case AlgorithmType::BFS:
+      return !options.allowDiagonal;
+    case AlgorithmType::ASTAR:
+    case AlgorithmType::IDASTAR:
+    case AlgorithmType::ARASTAR:
+    case AlgorithmType::FOCAL:
+      return admissible && options.weight <= 1.0;
+    default:
+      return false;
+  }
+}
+
+bool RouteCache::lookup(const RouteKey& key, Result& out) {
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    entries_.splice(entries_.begin(), entries_, found->second);
+    out = found->second->result;
+    ++hits_;
+    return true;
+  }
+
+  // Look for a cached shortest path that passes through start and later through goal.
+  auto starts = nodeIndex_.equal_range(NodeKey{key.config, key.start});
+  auto goals = nodeIndex_.equal_range(NodeKey{key.config, key.goal});
+  for (auto s = starts.first; s != starts.second; ++s) {
+    for (auto g = goals.first; g != goals.second; ++g) {
+      if (g->second.entry != s->second.entry || g->second.position < s->second.position) continue;
+      const Entry& e = *s->second.entry;
+      const auto first = e.result.path.begin() + static_cast<std::ptrdiff_t>(s->second.position);
+      const auto last = e.result.path.begin() + static_cast<std::ptrdiff_t>(g->second.position) + 1;
+      out.path.assign(first, last);
+      // A step's code sits at the index of the node it leaves.
+      if (!e.result.chainCode.empty()) {
+        out.chainStart = out.path.front();
+        out.chainCode.assign(e.result.chainCode.begin() + static_cast<std::ptrdiff_t>(s->second.position),
+                             e.result.chainCode.begin() + static_cast<std::ptrdiff_t>(g->second.position));
+      }
+      out.cost = e.prefix[g->second.position] - e.prefix[s->second.position];
+      out.success = true;
+      out.status = SearchStatus::SUCCESS;
+      out.suboptimalityBound = 1.0;
+      entries_.splice(entries_.begin(), entries_, s->second.entry);
+      ++hits_;
+      ++subpathHits_;
+      return true;
+    }
+  }
+
+  ++misses_;
+  return false;
+}
+
+void RouteCache::insert(const RouteKey& key, const Result& result, bool optimal, int width,
+                        const TerrainCosts& terrain) {
+  auto existing = index_.find(key);
+  if (existing != index_.end()) erase(existing->second);
+
+  Entry entry{key, Result{}, {}, width};
+  entry.result.path = result.path;
+  entry.result.cost = result.cost;
+  entry.result.success = result.success;
+  entry.result.status = result.status;
+  entry.result.suboptimalityBound = result.suboptimalityBound;
+  entry.result.waypoints = result.waypoints;
+  entry.result.waypointCost = result.waypointCost;
+  entry.result.chainStart = result.chainStart;
+  entry.result.chainCode = result.chainCode;
+
+  // Only index paths whose step costs we can reproduce, so subpath costs are exact. Subpaths carry
+  // no waypoints, so routes asked for with smoothing are only served whole.
+  if (optimal && result.success && !result.path.empty() && key.config.smoothing == PathSmoothing::NONE) {
+    entry.prefix.resize(result.path.size(), 0.0);
+    for (std::size_t i = 1; i < result.path.size(); ++i) {
+      entry.prefix[i] = entry.prefix[i - 1] + stepCost(width, terrain, result.path[i - 1], result.path[i]);
+    }
+    if (std::fabs(entry.prefix.back() - result.cost) > 1e-6 * std::max<Cost>(1.0, result.cost)) {
+      entry.prefix.clear();
+    }
+  }
+
+  entries_.push_front(std::move(entry));
+  auto it = entries_.begin();
+  index_.emplace(key, it);
+  for (std::size_t i = 0; i < it->prefix.size(); ++i) {
+    nodeIndex_.emplace(NodeKey{key.config, it->result.path[i]}, Occurrence{it, i});
+  }
+
+  while (entries_.size() > capacity_) erase(std::prev(entries_.end()));
+}
+
+void RouteCache::erase(EntryList::iterator it) {
+  for (std::size_t i = 0; i < it->prefix.size(); ++i) {
+    auto range = nodeIndex_.equal_range(NodeKey{it->key.config, it->result.path[i]});
+    for (auto o = range.first; o != range.second; ++o) {
+      if (o->second.entry == it) {
+        nodeIndex_.erase(o);
+        break;
+      }
+    }
+  }
+  index_.erase(it->key);
+  entries_.erase(it);
+}
+
+Result RouteCache::findPath(
+    const uint8_t* grid,
+    std::size_t gridSize,
+    int width,
+    int height,
+    int startIndex,
+    int goalIndex,
+    const EngineOptions& options,
+    uint64_t mapVersion) {
+  const auto t0 = std::chrono::steady_clock::now();
+
+  if (width > 0 && startIndex >= 0 && goalIndex >= 0) {
+    const RouteKey key{configKey(mapVersion, options), static_cast<NodeId>(startIndex), static_cast<NodeId>(goalIndex)};
+    Result cached(options.resultMemory);
+    bool hit = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      hit = lookup(key, cached);
+    }
+    if (hit) {
+      cached.cacheHit = true;
+      cached.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+      LOG_INFO(std::string("RouteCache: hit from=") + std::to_string(startIndex) + " to=" + std::to_string(goalIndex));
+      return cached;
+    }
+
+    const std::shared_ptr<const ComponentLabels> labels =
+        labels_.labelsFor(grid, gridSize, width, height, options.terrain, mapVersion);
+    EngineOptions labelled = options;
+    labelled.components = labels.get();
+    Result res = PathfindingEngine::findPath(grid, gridSize, width, height, startIndex, goalIndex, labelled);
+    if (res.status == SearchStatus::SUCCESS || res.status == SearchStatus::NO_PATH) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      insert(key, res, isOptimal(options), width, options.terrain);
+    }
+    return res;
+  }
+
+  return PathfindingEngine::findPath(grid, gridSize, width, height, startIndex, goalIndex, options);
+}
+
+void RouteCache::invalidate(uint64_t mapVersion) {
+  labels_.drop(mapVersion);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    auto next = std::next(it);
+    if (it->key.config.mapVersion == mapVersion) erase(it);
+    it = next;
+  }
+}
+
+void RouteCache::invalidateCell(uint64_t mapVersion, NodeId cell, bool blocked) {
+  if (!blocked) {
+    invalidate(mapVersion);
+    return;
+  }
+  // The new wall may split a component.
+  labels_.drop(mapVersion);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    auto next = std::next(it);
+    if (it->key.config.mapVersion == mapVersion && routeTouches(it->width, it->result, cell, it->key.config.dontCrossCorners)) {
+      erase(it);
+    }
+    it = next;
+  }
+}
+
+void RouteCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  nodeIndex_.clear();
+  index_.clear();
+  entries_.clear();
+  labels_.clear();
+}
+
+std::size_t RouteCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+std::size_t RouteCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+std::size_t RouteCache::subpathHits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return subpathHits_;
+}
+
+std::size_t RouteCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
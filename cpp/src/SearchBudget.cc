@@ -0,0 +1,42 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <chrono>
+
+#include "algorithms/SearchBudget.hh"
+#include "utils/Logger.hh"
+
+SearchBudget::SearchBudget(const AlgorithmConfig& config, NodeId start, NodeId goal)
+    : config_(config),
+      goal_(goal),
+      limited_(config.maxExpansions != 0 || config.cancel != nullptr ||
+               config.deadline != std::chrono::steady_clock::time_point::max()),
+      closest_(start) {}
+
+void SearchBudget::offer(NodeId u) {
+  if (!config_.heuristic) {
+    closest_ = u;
+    return;
+  }
+  const Cost h = config_.heuristic->compute(u, goal_);
+  if (h < closestH_) {
+    closestH_ = h;
+    closest_ = u;
+  }
+}
+
+bool SearchBudget::pollSlow() {
+  if (config_.cancel && config_.cancel->isCancelled()) {
+    status_ = SearchStatus::CANCELLED;
+    LOG_WARN("SearchBudget: search cancelled after " + std::to_string(expansions_) + " expansions");
+    return true;
+  }
+  if (std::chrono::steady_clock::now() >= config_.deadline) {
+    status_ = SearchStatus::TIMEOUT;
+    LOG_WARN("SearchBudget: deadline reached after " + std::to_string(expansions_) + " expansions");
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,191 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "algorithms/ThetaStar.hh"
+#include "algorithms/VisitRecorder.hh"
+#include "algorithms/SearchBudget.hh"
+#include "algorithms/StatsRecorder.hh"
+#include "utils/Logger.hh"
+
+namespace {
+
+struct ThetaNode {
+  Cost f;
+  Cost g;
+  NodeId id;
+  bool operator>(const ThetaNode& o) const { return f > o.f; }
+};
+
+bool adjacent(const Point& a, const Point& b) {
+  return std::abs(a.x - b.x) <= 1 && std::abs(a.y - b.y) <= 1;
+}
+
+} // namespace
+
+Result ThetaStar::findPath(const IGraph& graph, NodeId start, NodeId goal, const AlgorithmConfig& config) {
+  Result res(config.resultMemory); res.success = false; res.cost = 0.0; res.time = Time::zero();
+  const auto t0 = std::chrono::steady_clock::now();
+  StatsRecorder stats(res);
+  const char* name = lazy_ ? "LazyTheta*" : "Theta*";
+
+  LOG_INFO(std::string(name) + ": start from=" + std::to_string(start) + " to=" + std::to_string(goal));
+
+  if (!config.heuristic) {
+    LOG_ERROR(std::string(name) + ": no heuristic provided in config");
+    return res;
+  }
+  const IHeuristic& h = *config.heuristic;
+  const Cost w = std::max<Cost>(1.0, config.weight);
+
+  NodeCount n = graph.getNodeCount();
+  if (start >= n || goal >= n) {
+    LOG_ERROR(std::string(name) + ": invalid start/goal");
+    return res;
+  }
+
+  // A straight segment's cost is only its length times the step cost when every cell costs the same.
+  const bool anyAngle = graph.isUniformGrid();
+  if (!anyAngle) LOG_DEBUG(std::string(name) + ": graph is not a uniform-cost grid; searching its edges only");
+  const Cost unit = graph.getMinStepCost();
+  const auto segment = [&](NodeId a, NodeId b) {
+    const Point pa = graph.getNodePosition(a);
+    const Point pb = graph.getNodePosition(b);
+    return unit * std::hypot(static_cast<Cost>(pa.x - pb.x), static_cast<Cost>(pa.y - pb.y));
+  };
+  // Parents adjacent to the node are joined by a graph edge, which needs no line-of-sight check.
+  const auto sees = [&](NodeId a, NodeId b) {
+    return adjacent(graph.getNodePosition(a), graph.getNodePosition(b)) || graph.lineOfSight(a, b);
+  };
+
+  const Cost INF = std::numeric_limits<Cost>::infinity();
+  const NodeId NONE = static_cast<NodeId>(-1);
+  std::vector<Cost> gScore(n, INF);
+  std::vector<NodeId> parent(n, NONE);
+  std::vector<bool> closed(n, false);
+
+  using PQ = std::priority_queue<ThetaNode, std::vector<ThetaNode>, std::greater<ThetaNode>>;
+  PQ open;
+  const auto push = [&](NodeId v) {
+    open.push(ThetaNode{gScore[v] + w * h.compute(v, goal), gScore[v], v});
+    stats.heuristicCall();
+    stats.pushed(open.size());
+  };
+
+  gScore[start] = 0.0;
+  parent[start] = start;
+  push(start);
+
+  std::vector<Edge> neighbors;
+  VisitRecorder recorder(res, config, n);
+  SearchBudget budget(config, start, goal);
+  stats.endSetup();
+
+  while (!open.empty()) {
+    const ThetaNode cur = open.top(); open.pop();
+    stats.popped();
+    const NodeId u = cur.id;
+    if (closed[u] || cur.g != gScore[u]) {
+      stats.stalePop();
+      continue;
+    }
+    recorder.record(u);
+    graph.getNeighbors(u, neighbors);
+
+    // Lazy Theta* generated u assuming its parent sees it; if not, settle for the best expanded
+    // neighbour instead. One of them generated u, so there always is one.
+    if (lazy_ && anyAngle && parent[u] != u && !sees(parent[u], u)) {
+      gScore[u] = INF;
+      for (const Edge& e : neighbors) {
+        if (!closed[e.id]) continue;
+        const Point pu = graph.getNodePosition(u);
+        const Point pv = graph.getNodePosition(e.id);
+        if (!config.allowDiagonal && pu.x != pv.x && pu.y != pv.y) continue;
+        if (gScore[e.id] + e.cost < gScore[u]) {
+          gScore[u] = gScore[e.id] + e.cost;
+          parent[u] = e.id;
+        }
+      }
+    }
+    closed[u] = true;
+    if (u == goal) break;
+    stats.expanded();
+    if (budget.exhausted(u)) break;
+
+    for (const Edge& e : neighbors) {
+      if (closed[e.id]) continue;
+      // option to ignore diagonals if config disallows them
+      if (!config.allowDiagonal) {
+        Point pu = graph.getNodePosition(u);
+        Point pv = graph.getNodePosition(e.id);
+        int dx = std::abs(pu.x - pv.x);
+        int dy = std::abs(pu.y - pv.y);
+        if (dx == 1 && dy == 1) continue; // skip diagonal
+      }
+      stats.generated();
+
+      // Path 2: straight from u's parent, when it sees the successor (Lazy Theta* checks later).
+      NodeId from = u;
+      Cost tentative_g = gScore[u] + e.cost;
+      const NodeId p = parent[u];
+      if (anyAngle && p != u && (lazy_ || sees(p, e.id))) {
+        const Cost viaParent = gScore[p] + segment(p, e.id);
+        if (lazy_ || viaParent < tentative_g) {
+          from = p;
+          tentative_g = viaParent;
+        }
+      }
+      if (tentative_g < gScore[e.id]) {
+        gScore[e.id] = tentative_g;
+        parent[e.id] = from;
+        push(e.id);
+      }
+    }
+  }
+  stats.endSearch();
+  recorder.flush();
+  stats.workspace(StatsRecorder::bytes(gScore) + StatsRecorder::bytes(parent) + StatsRecorder::bytes(closed) +
+                  StatsRecorder::bytes(neighbors) + res.stats.peakOpen * sizeof(ThetaNode));
+
+  // An interrupted search returns the path to the expanded node closest to the goal.
+  const bool stopped = budget.status() != SearchStatus::SUCCESS;
+  const NodeId target = stopped ? budget.closest() : goal;
+
+  if (!stopped && !closed[goal]) {
+    res.success = false;
+    res.status = SearchStatus::NO_PATH;
+    res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+    LOG_WARN(std::string(name) + ": no path found");
+    return res;
+  }
+
+  for (NodeId cur = target; cur != NONE; cur = parent[cur]) {
+    res.path.push_back(cur);
+    if (cur == start) break;
+  }
+  std::reverse(res.path.begin(), res.path.end());
+  stats.endReconstruct();
+
+  res.cost = gScore[target];
+  res.status = budget.status();
+  res.time = std::chrono::duration_cast<Time>(std::chrono::steady_clock::now() - t0);
+  if (stopped) {
+    LOG_WARN(std::string(name) + ": stopped, partial cost=" + std::to_string(res.cost));
+    return res;
+  }
+  res.success = true;
+  // Any-angle paths carry no proven bound relative to the shortest any-angle path.
+  res.suboptimalityBound = INF;
+  LOG_INFO(std::string(name) + ": success cost=" + std::to_string(res.cost));
+  return res;
+}
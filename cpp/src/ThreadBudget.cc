@@ -0,0 +1,46 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "utils/ThreadBudget.hh"
+
+namespace utils {
+
+namespace {
+
+thread_local bool inWorker = false;
+
+} // namespace
+
+unsigned threadBudget(unsigned maxThreads) {
+  if (inWorker) return 1;
+  unsigned threads = maxThreads != 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+  if (PATHFINDING_THREAD_POOL > 0) threads = std::min(threads, static_cast<unsigned>(PATHFINDING_THREAD_POOL) + 1);
+  return threads;
+}
+
+WorkerScope::WorkerScope() : previous_(inWorker) { inWorker = true; }
+
+WorkerScope::~WorkerScope() { inWorker = previous_; }
+
+unsigned runOnThreads(unsigned threads, const std::function<void()>& work) {
+  std::vector<std::thread> workers;
+  for (unsigned t = 1; t < threads; ++t) {
+    try {
+      workers.emplace_back(work);
+    } catch (const std::system_error&) {
+      break;
+    }
+  }
+  work();
+  for (std::thread& worker : workers) worker.join();
+  return static_cast<unsigned>(workers.size()) + 1;
+}
+
+} // namespace utils
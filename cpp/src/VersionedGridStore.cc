@@ -0,0 +1,250 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "graph/VersionedGridStore.hh"
+#include "utils/Logger.hh"
+
+namespace {
+
+// Same 8-direction order and costs as GridGraph so results match on identical maps.
+constexpr int kOffsets[8][2] = {{1,0},{-1,0},{0,1},{0,-1},{1,1},{1,-1},{-1,1},{-1,-1}};
+constexpr int kFirstDiagonal = 4;
+
+const Cost kSqrt2 = static_cast<Cost>(std::sqrt(2.0));
+
+} // namespace
+
+VersionedGridStore::VersionedGridStore(int width, int height, const std::vector<uint8_t>& grid, int tileSize)
+    : width_(width), height_(height), tileShift_(0), tilesX_(0), tilesY_(0), current_(nullptr) {
+  if (width <= 0 || height <= 0 ||
+      grid.size() != static_cast<std::size_t>(width) * static_cast<std::size_t>(height) ||
+      grid.size() > std::numeric_limits<NodeId>::max()) {
+    LOG_ERROR("VersionedGridStore ctor: grid.size() does not match width*height");
+    throw std::invalid_argument("grid.size() does not match width*height");
+  }
+  if (tileSize <= 0 || (tileSize & (tileSize - 1)) != 0) {
+    LOG_ERROR("VersionedGridStore ctor: tileSize=" + std::to_string(tileSize) + " is not a power of two");
+    throw std::invalid_argument("tileSize must be a power of two");
+  }
+
+  while ((1 << tileShift_) < tileSize) ++tileShift_;
+  tilesX_ = (width_ + tileSize - 1) / tileSize;
+  tilesY_ = (height_ + tileSize - 1) / tileSize;
+
+  // Tiles on the right/bottom border are padded with blocked cells, as in tiled map files.
+  auto* version = new Version{0, {}, {}};
+  const std::size_t tiles = static_cast<std::size_t>(tilesX_) * static_cast<std::size_t>(tilesY_);
+  version->tiles.reserve(tiles);
+  version->cells.reserve(tiles);
+  for (int ty = 0; ty < tilesY_; ++ty) {
+    for (int tx = 0; tx < tilesX_; ++tx) {
+      auto tile = std::make_shared<Tile>();
+      tile->cells.assign(static_cast<std::size_t>(tileSize) * static_cast<std::size_t>(tileSize), 1);
+      for (int cy = 0; cy < tileSize && ty * tileSize + cy < height_; ++cy) {
+        const int x0 = tx * tileSize;
+        const int count = std::min(tileSize, width_ - x0);
+        const std::size_t src = static_cast<std::size_t>(ty * tileSize + cy) * static_cast<std::size_t>(width_) +
+                                static_cast<std::size_t>(x0);
+        std::copy_n(grid.begin() + static_cast<std::ptrdiff_t>(src), count,
+                    tile->cells.begin() + static_cast<std::ptrdiff_t>(cy) * tileSize);
+      }
+      version->cells.push_back(tile->cells.data());
+      version->tiles.push_back(std::move(tile));
+    }
+  }
+  current_.store(version);
+
+  LOG_INFO("VersionedGridStore ctor: width=" + std::to_string(width_) + " height=" + std::to_string(height_) +
+           " tileSize=" + std::to_string(tileSize) + " tiles=" + std::to_string(tiles));
+}
+
+VersionedGridStore::~VersionedGridStore() {
+  delete current_.load();
+  for (const auto& entry : retired_) delete entry.second;
+  for (ReaderSlot* slot = readers_.load(); slot != nullptr;) {
+    ReaderSlot* next = slot->next;
+    delete slot;
+    slot = next;
+  }
+}
+
+// Claiming a slot announces the epoch it is claimed at. Idle slots are reused; when every slot is
+// taken a new one is pushed onto the list, so readers never wait for each other.
+VersionedGridStore::ReaderSlot* VersionedGridStore::claimSlot() const {
+  for (ReaderSlot* slot = readers_.load(); slot != nullptr; slot = slot->next) {
+    uint64_t idle = kIdle;
+    if (slot->epoch.load(std::memory_order_relaxed) == kIdle && slot->epoch.compare_exchange_strong(idle, epoch_.load())) {
+      return slot;
+    }
+  }
+  auto* slot = new ReaderSlot;
+  slot->epoch.store(epoch_.load(), std::memory_order_relaxed);
+  slot->next = readers_.load();
+  while (!readers_.compare_exchange_weak(slot->next, slot)) {
+  }
+  return slot;
+}
+
+std::shared_ptr<const VersionedGridStore::Snapshot> VersionedGridStore::snapshot() const {
+  // The epoch is announced before the version is loaded: a writer that retires this version
+  // afterwards tags it with that epoch or a later one, and so sees the announcement.
+  ReaderSlot* slot = claimSlot();
+  const Version* version = current_.load();
+  try {
+    return std::shared_ptr<const Snapshot>(new Snapshot(*this, slot, version));
+  } catch (...) {
+    slot->epoch.store(kIdle, std::memory_order_release);
+    throw;
+  }
+}
+
+uint64_t VersionedGridStore::apply(const std::vector<CellEdit>& edits) {
+  std::lock_guard<std::mutex> lk(writeMutex_);
+  const Version* old = current_.load(std::memory_order_relaxed);
+  const NodeCount n = static_cast<NodeCount>(width_) * static_cast<NodeCount>(height_);
+  const int mask = (1 << tileShift_) - 1;
+
+  // The new version and its private tile copies are only made once an edit changes something.
+  std::unique_ptr<Version> next;
+  std::vector<Tile*> copies;
+  for (const CellEdit& edit : edits) {
+    if (edit.cell >= n) {
+      LOG_WARN("VersionedGridStore::apply: invalid cell=" + std::to_string(edit.cell));
+      continue;
+    }
+    const int x = static_cast<int>(edit.cell % static_cast<NodeId>(width_));
+    const int y = static_cast<int>(edit.cell / static_cast<NodeId>(width_));
+    const auto t = static_cast<std::size_t>((y >> tileShift_) * tilesX_ + (x >> tileShift_));
+    const auto offset = static_cast<std::size_t>(((y & mask) << tileShift_) + (x & mask));
+    const Version& latest = next ? *next : *old;
+    if ((latest.cells[t][offset] != 0) == edit.blocked) continue;
+
+    if (!next) {
+      next = std::make_unique<Version>(*old);
+      next->number = old->number + 1;
+      copies.assign(next->tiles.size(), nullptr);
+    }
+    if (copies[t] == nullptr) {
+      auto copy = std::make_shared<Tile>(*next->tiles[t]);
+      copies[t] = copy.get();
+      next->cells[t] = copy->cells.data();
+      next->tiles[t] = std::move(copy);
+    }
+    copies[t]->cells[offset] = edit.blocked ? 1 : 0;
+  }
+  if (!next) return old->number;
+
+  const uint64_t number = next->number;
+  current_.store(next.release());
+  currentNumber_.store(number);
+  retired_.emplace_back(epoch_.fetch_add(1), old);
+  reclaim();
+  return number;
+}
+
+// Caller must hold writeMutex_. A version retired at epoch r may still be read by a snapshot that
+// announced r or earlier; once every claimed slot shows a later epoch, nobody can reach it.
+void VersionedGridStore::reclaim() {
+  uint64_t oldest = kIdle;
+  for (ReaderSlot* slot = readers_.load(); slot != nullptr; slot = slot->next) {
+    oldest = std::min(oldest, slot->epoch.load());
+  }
+  const auto reachable = std::partition(retired_.begin(), retired_.end(),
+                                        [oldest](const auto& entry) { return entry.first >= oldest; });
+  for (auto it = reachable; it != retired_.end(); ++it) delete it->second;
+  retired_.erase(reachable, retired_.end());
+}
+
+std::size_t VersionedGridStore::retiredCount() const {
+  std::lock_guard<std::mutex> lk(writeMutex_);
+  return retired_.size();
+}
+
+VersionedGridStore::Snapshot::~Snapshot() { slot_->epoch.store(kIdle, std::memory_order_release); }
+
+bool VersionedGridStore::Snapshot::isWalkable(NodeId nodeId) const {
+  if (nodeId >= getNodeCount()) return false;
+  const Point p = getNodePosition(nodeId);
+  return walkableAt(p.x, p.y);
+}
+
+NodeCount VersionedGridStore::Snapshot::getNodeCount() const {
+  return static_cast<NodeCount>(store_.width_) * static_cast<NodeCount>(store_.height_);
+}
+
+void VersionedGridStore::Snapshot::getNeighbors(NodeId id, std::vector<Edge>& out) const {
+  out.clear();
+  if (id >= getNodeCount()) {
+    LOG_WARN("VersionedGridStore::Snapshot::getNeighbors: invalid node id=" + std::to_string(id));
+    return;
+  }
+
+  const int x = static_cast<int>(id % static_cast<NodeId>(store_.width_));
+  const int y = static_cast<int>(id / static_cast<NodeId>(store_.width_));
+  for (int d = 0; d < 8; ++d) {
+    const int nx = x + kOffsets[d][0];
+    const int ny = y + kOffsets[d][1];
+    if (!walkableAt(nx, ny)) continue;
+    const NodeId nid = static_cast<NodeId>(ny) * static_cast<NodeId>(store_.width_) + static_cast<NodeId>(nx);
+    out.push_back(Edge{nid, d >= kFirstDiagonal ? kSqrt2 : 1.0});
+  }
+}
+
+Point VersionedGridStore::Snapshot::getNodePosition(NodeId nodeId) const {
+  if (nodeId >= getNodeCount()) {
+    LOG_WARN("VersionedGridStore::Snapshot::getNodePosition: invalid nodeId=" + std::to_string(nodeId));
+    return Point{0, 0};
+  }
+  return Point{static_cast<int>(nodeId % static_cast<NodeId>(store_.width_)),
+               static_cast<int>(nodeId / static_cast<NodeId>(store_.width_))};
+}
+
+Cost VersionedGridStore::Snapshot::getEdgeCost(NodeId from, NodeId to) const {
+  const Cost none = std::numeric_limits<Cost>::infinity();
+  if (from >= getNodeCount() || to >= getNodeCount()) return none;
+  const Point a = getNodePosition(from);
+  const Point b = getNodePosition(to);
+  const int dx = std::abs(b.x - a.x);
+  const int dy = std::abs(b.y - a.y);
+  if (dx > 1 || dy > 1 || (dx == 0 && dy == 0) || !walkableAt(b.x, b.y)) return none;
+  return (dx != 0 && dy != 0) ? kSqrt2 : 1.0;
+}
+
+bool VersionedGridStore::Snapshot::lineOfSight(NodeId from, NodeId to) const {
+  if (from >= getNodeCount() || to >= getNodeCount()) return false;
+  const Point p0 = getNodePosition(from);
+  const Point p1 = getNodePosition(to);
+  int x = p0.x;
+  int y = p0.y;
+  const int dx = std::abs(p1.x - x);
+  const int dy = std::abs(p1.y - y);
+  const int sx = p1.x > x ? 1 : -1;
+  const int sy = p1.y > y ? 1 : -1;
+
+  // error tracks which cell border the segment crosses next: positive means a vertical border
+  // (step in x), negative a horizontal one (step in y), zero a corner (step both).
+  int error = dx - dy;
+  for (;;) {
+    if (!walkableAt(x, y)) return false;
+    if (x == p1.x && y == p1.y) return true;
+    if (error > 0) {
+      x += sx;
+      error -= 2 * dy;
+    } else if (error < 0) {
+      y += sy;
+      error += 2 * dx;
+    } else {
+      if (!walkableAt(x + sx, y) || !walkableAt(x, y + sy)) return false;
+      x += sx;
+      y += sy;
+      error += 2 * (dx - dy);
+    }
+  }
+}
@@ -0,0 +1,87 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+
+#include "algorithms/VisitRecorder.hh"
+#include "utils/Logger.hh"
+
+VisitRecorder::VisitRecorder(Result& result, const AlgorithmConfig& config, NodeCount nodeCount)
+    : result_(result), mode_(config.recording), sampleRate_(config.recordingSampleRate > 0 ? config.recordingSampleRate : 1) {
+  if (mode_ == VisitedRecording::BITMAP) {
+    result_.visitedBitmap.assign((static_cast<std::size_t>(nodeCount) + 31) / 32, 0u);
+  }
+  if (mode_ == VisitedRecording::STREAM) {
+    if (!config.onVisited) {
+      LOG_WARN("VisitRecorder: STREAM recording without an onVisited sink; nothing is recorded");
+      mode_ = VisitedRecording::OFF;
+      return;
+    }
+    sink_ = &config.onVisited;
+    chunkSize_ = std::max<std::size_t>(config.visitChunkSize, 1);
+    chunk_.reserve(chunkSize_);
+  }
+}
+
+void VisitRecorder::flush() {
+  if (chunk_.empty()) return;
+  (*sink_)(chunk_.data(), chunk_.size());
+  chunk_.clear();
+}
+
+std::vector<NodeId> VisitRecorder::decodeDeltas(const uint8_t* bytes, std::size_t size) {
+  std::vector<NodeId> ids;
+  int64_t id = 0;
+  uint64_t code = 0;
+  unsigned shift = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    code |= static_cast<uint64_t>(bytes[i] & 0x7f) << shift;
+    if (bytes[i] & 0x80) {
+      shift += 7;
+      continue;
+    }
+    id += (code & 1) ? -static_cast<int64_t>((code + 1) >> 1) : static_cast<int64_t>(code >> 1);
+    ids.push_back(static_cast<NodeId>(id));
+    code = 0;
+    shift = 0;
+  }
+  return ids;
+}
+
+void VisitRecorder::recordCompact(NodeId id) {
+  switch (mode_) {
+    case VisitedRecording::SAMPLED:
+      // Keep the first expansion and every sampleRate-th one after it.
+      if (untilSample_ == 0) {
+        result_.visited.push_back(id);
+        untilSample_ = sampleRate_;
+      }
+      --untilSample_;
+      break;
+    case VisitedRecording::BITMAP:
+      if (id / 32 < result_.visitedBitmap.size()) {
+        result_.visitedBitmap[id / 32] |= (1u << (id % 32));
+      }
+      break;
+    case VisitedRecording::DELTAS: {
+      // Zig-zag maps small deltas of either sign to small codes, written 7 bits per byte.
+      const int64_t delta = static_cast<int64_t>(id) - static_cast<int64_t>(lastId_);
+      uint64_t code = delta >= 0 ? static_cast<uint64_t>(delta) << 1 : (static_cast<uint64_t>(-delta) << 1) - 1;
+      while (code >= 0x80) {
+        result_.visitedDeltas.push_back(static_cast<uint8_t>(code | 0x80));
+        code >>= 7;
+      }
+      result_.visitedDeltas.push_back(static_cast<uint8_t>(code));
+      lastId_ = id;
+      break;
+    }
+    case VisitedRecording::STREAM:
+      chunk_.push_back(id);
+      if (chunk_.size() == chunkSize_) flush();
+      break;
+    default:
+      break;
+  }
+}
@@ -23,7 +23,7 @@ export function useRun(): RunReturns {
 		setLastResult: setSecondLastResult,
 	} = useSecondAlgorithm();
 	const { mode } = useModeStore();
-	const { ready, findPath } = useWebAssembly();
+	const { ready, findPath, findPaths } = useWebAssembly();
 
 	const { initializeAudio, playVisitedSound, playPathSound, playSuccessChord } = useSound();
 
@@ -213,8 +213,11 @@ export function useRun(): RunReturns {
 				const firstGrid = baseGridData.slice();
 				const secondGrid = baseGridData.slice();
 
-				const firstResult = findPath(buildParams(firstGrid, algorithm, config));
-				const secondResult = findPath(buildParams(secondGrid, secondAlgorithm, secondConfig));
+				// One batch, so the threaded module searches both grids at the same time.
+				const [firstResult, secondResult] = findPaths([
+					buildParams(firstGrid, algorithm, config),
+					buildParams(secondGrid, secondAlgorithm, secondConfig),
+				]);
 
 				setLastResult({ cost: firstResult.cost, visited: firstResult.visited });
 				setSecondLastResult({ cost: secondResult.cost, visited: secondResult.visited });
@@ -255,6 +258,7 @@ export function useRun(): RunReturns {
 		mode,
 		ready,
 		findPath,
+		findPaths,
 	]);
 
 	return { execute };
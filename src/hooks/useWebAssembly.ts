@@ -18,6 +18,64 @@ interface WebAssemblyReturns {
 	 * PublicAPI to find the shortest path in the grid using the specified algorithm and parameters
 	 */
 	findPath: (params: PathfindingParams) => PathfindingResponse;
+
+	/**
+	 * Run a search and receive its expanded nodes in chunks while it runs; `visited` in the
+	 * response stays empty
+	 */
+	findPathStreaming: (
+		params: PathfindingParams,
+		onVisited: (ids: Uint32Array) => void,
+		chunkSize?: number,
+	) => PathfindingResponse;
+
+	/**
+	 * Answer several independent searches at once; the threaded build runs them in parallel
+	 */
+	findPaths: (batch: PathfindingParams[]) => PathfindingResponse[];
+}
+
+/**
+ * Build the embind PathfindingConfig for one search
+ */
+function toConfig(
+	mod: MainModule,
+	{ algorithm, heuristic, allowDiagonal, dontCrossCorners, bidirectional }: PathfindingParams,
+): any {
+	return {
+		algorithm,
+		heuristic: heuristic ?? (mod.HeuristicType ? mod.HeuristicType.MANHATTAN : undefined),
+		allowDiagonal,
+		dontCrossCorners,
+		bidirectional,
+		// The visualizer animates the full expansion order.
+		recording: (mod as any).VisitedRecording?.FULL,
+		recordingSampleRate: 1,
+		weight: 1,
+		timeBudgetUs: 0,
+		maxExpansions: 0,
+		tieBreaking: (mod as any).TieBreaking?.NONE,
+		canonicalOrdering: false,
+		precision: (mod as any).CostPrecision?.DOUBLE,
+		smoothing: (mod as any).PathSmoothing?.NONE,
+		chainCode: false,
+		keepCellPath: true,
+		mapVersion: 0,
+	};
+}
+
+/**
+ * Convert a raw module result; path/visited are views over module memory reused by the next call,
+ * so they are copied out
+ */
+function toResponse(raw: any): PathfindingResponse {
+	const path: number[] = raw.path ? Array.from(raw.path as ArrayLike<number>) : [];
+	const visited: number[] = raw.visited ? Array.from(raw.visited as ArrayLike<number>) : [];
+	const success: boolean = Boolean(raw.success);
+	const cost: number = Number(raw.cost ?? 0);
+	const time: number = Number(raw.time_us ?? raw.time ?? 0);
+
+	return { path, visited, success, cost, time };
 }
 
 /**
@@ -54,53 +112,77 @@ export function useWebAssembly(): WebAssemblyReturns {
 		};
 	}, []);
 
-	const findPath = useCallback(
-		({
-			grid,
-			width,
-			height,
-			startIndex,
-			goalIndex,
-			algorithm,
-			heuristic,
-			allowDiagonal,
-			dontCrossCorners,
-			bidirectional,
-		}: PathfindingParams): PathfindingResponse => {
+	const findPath = useCallback((params: PathfindingParams): PathfindingResponse => {
+		const mod = moduleRef.current;
+		if (!mod) throw new Error("WebAssembly module is not ready");
+
+		const { grid, width, height, startIndex, goalIndex } = params;
+		const api = (mod as any).PathfindingAPI;
+
+		// Write the grid straight into module memory so the engine reads it in place.
+		let input: Uint8Array | number[] = grid;
+		if (typeof api.gridBuffer === "function") {
+			const view: Uint8Array = api.gridBuffer(grid.length);
+			view.set(grid);
+			input = view;
+		}
+
+		return toResponse(api.findPath(input, width, height, startIndex, goalIndex, toConfig(mod, params)));
+	}, []);
+
+	const findPathStreaming = useCallback(
+		(
+			params: PathfindingParams,
+			onVisited: (ids: Uint32Array) => void,
+			chunkSize = 1024,
+		): PathfindingResponse => {
 			const mod = moduleRef.current;
 			if (!mod) throw new Error("WebAssembly module is not ready");
 
-			const cfg: any = {
-				algorithm,
-				heuristic: heuristic ?? (mod.HeuristicType ? mod.HeuristicType.MANHATTAN : undefined),
-				allowDiagonal,
-				dontCrossCorners,
-				bidirectional,
-			};
-
-			const raw = (mod as any).PathfindingAPI.findPath(
+			const { grid, width, height, startIndex, goalIndex } = params;
+			const api = (mod as any).PathfindingAPI;
+			// Chunks are views over one module buffer reused for the next chunk: hand out copies.
+			const raw = api.findPathStreaming(
 				grid,
 				width,
 				height,
 				startIndex,
 				goalIndex,
-				cfg,
+				toConfig(mod, params),
+				(ids: Uint32Array) => onVisited(ids.slice()),
+				chunkSize,
 			);
+			return toResponse(raw);
+		},
+		[],
+	);
 
-			const path: number[] = Array.isArray(raw.path) ? raw.path.map((v: any) => Number(v)) : [];
-			const visited: number[] = Array.isArray(raw.visited)
-				? raw.visited.map((v: any) => Number(v))
-				: [];
-			const success: boolean = Boolean(raw.success);
-			const cost: number = Number(raw.cost ?? 0);
-			const time: number = Number(raw.time_us ?? raw.time ?? 0);
+	const findPaths = useCallback(
+		(batch: PathfindingParams[]): PathfindingResponse[] => {
+			const mod = moduleRef.current;
+			if (!mod) throw new Error("WebAssembly module is not ready");
 
-			return { path, visited, success, cost, time };
+			const api = (mod as any).PathfindingAPI;
+			// Builds without findPathBatch (older bundles) answer the queries one after another.
+			if (typeof api.findPathBatch !== "function") return batch.map(findPath);
+
+			const queries = batch.map((params) => ({
+				grid: params.grid,
+				width: params.width,
+				height: params.height,
+				startIndex: params.startIndex,
+				goalIndex: params.goalIndex,
+				config: toConfig(mod, params),
+			}));
+			// 0 threads: one per core, capped at the threaded build's prespawned pool plus this thread
+			// (a single-threaded build runs inline).
+			const raw: any[] = api.findPathBatch(queries, 0);
+			return raw.map(toResponse);
 		},
-		[],
+		[findPath],
 	);
 
-	return { ready, findPath };
+	return { ready, findPath, findPathStreaming, findPaths };
 }
 
 declare global {
@@ -9,10 +9,16 @@ export async function loadWasm(): Promise<MainModule> {
 
   wasmModulePromise = (async () => {
     try {
-      const wasmPath = '/wasm/pathfinding.js';
-      
-      // Load the WASM JS file
-      await loadScript(wasmPath);
+      // The threaded build needs SharedArrayBuffer, which only cross-origin isolated pages get
+      if (window.crossOriginIsolated) {
+        try {
+          await loadScript('/wasm/pathfinding-mt.js');
+        } catch {
+          await loadScript('/wasm/pathfinding.js');
+        }
+      } else {
+        await loadScript('/wasm/pathfinding.js');
+      }
       
       // The factory should now be available globally
       const factory = (window as any).PathfindingModule;
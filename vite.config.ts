@@ -4,6 +4,12 @@ import path from "path";
 import { defineConfig } from "vite";
 import wasm from "vite-plugin-wasm";
 
+// Cross-origin isolation unlocks SharedArrayBuffer for the threaded WASM build (pathfinding-mt.js).
+const crossOriginIsolation = {
+	"Cross-Origin-Opener-Policy": "same-origin",
+	"Cross-Origin-Embedder-Policy": "require-corp",
+};
+
 export default defineConfig({
 	plugins: [
 		react({
@@ -22,6 +28,12 @@ export default defineConfig({
 	ssr: {
 		external: ["pathfinding"],
 	},
+	server: {
+		headers: crossOriginIsolation,
+	},
+	preview: {
+		headers: crossOriginIsolation,
+	},
 	optimizeDeps: {
 		// Don't pre-bundle the WASM module
 		exclude: ["pathfinding"],